@@ -0,0 +1,174 @@
+#include "alloc_check.h"
+
+#include <webgpu/webgpu.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <unistd.h>
+#define TANIM_ALLOCATION_STACKS
+#endif
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace bench
+{
+constexpr int maxStackDepth = 64;
+
+// only the counting thread writes the counts
+static thread_local bool counting = false;
+static thread_local bool insideCounter = false;
+static AllocationCounts counts;
+
+static void* firstStack[maxStackDepth];
+static int firstStackDepth = 0;
+static const void* webgpuModule = nullptr;
+
+static void countAllocation()
+{
+  if (!counting || insideCounter)
+  {
+    return;
+  }
+  insideCounter = true;
+
+#ifdef TANIM_ALLOCATION_STACKS
+  void* stack[maxStackDepth];
+  int depth = backtrace(stack, maxStackDepth);
+
+  bool webgpu = false;
+  for (int i = 0; i < depth && webgpuModule && !webgpu; i++)
+  {
+    Dl_info info{};
+    webgpu = dladdr(stack[i], &info) && info.dli_fbase == webgpuModule;
+  }
+
+  if (webgpu)
+  {
+    counts.webgpu++;
+  }
+  else
+  {
+    if (counts.own == 0)
+    {
+      std::memcpy(firstStack, stack, depth * sizeof(void*));
+      firstStackDepth = depth;
+    }
+    counts.own++;
+  }
+#else
+  counts.own++;
+#endif
+
+  insideCounter = false;
+}
+
+void AllocationCounter::start()
+{
+#ifdef TANIM_ALLOCATION_STACKS
+  // the first backtrace loads the unwinder, which allocates
+  void* stack[1];
+  backtrace(stack, 1);
+
+  Dl_info webgpu{};
+  Dl_info own{};
+  if (dladdr(reinterpret_cast<void*>(&wgpuCreateInstance), &webgpu) &&
+      dladdr(reinterpret_cast<void*>(&countAllocation), &own))
+  {
+    webgpuModule =
+      webgpu.dli_fbase != own.dli_fbase ? webgpu.dli_fbase : nullptr;
+  }
+#endif
+
+  counts = {};
+  firstStackDepth = 0;
+  counting = true;
+}
+
+AllocationCounts AllocationCounter::stop()
+{
+  counting = false;
+  return counts;
+}
+
+bool AllocationCounter::separatesWebGpu()
+{
+#ifdef TANIM_ALLOCATION_STACKS
+  return webgpuModule != nullptr;
+#else
+  return true;
+#endif
+}
+
+void AllocationCounter::printFirstOwnAllocation()
+{
+#ifdef TANIM_ALLOCATION_STACKS
+  backtrace_symbols_fd(firstStack, firstStackDepth, STDERR_FILENO);
+#else
+  std::cerr << "(call stacks are not available on this platform)"
+            << std::endl;
+#endif
+}
+}  // namespace bench
+
+// the array and nothrow forms of the standard library forward to these
+void* operator new(size_t size)
+{
+  bench::countAllocation();
+  if (void* pointer = std::malloc(size > 0 ? size : 1))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+  std::free(pointer);
+}
+
+// over-aligned types, such as SIMD math, come through the aligned forms
+void* operator new(size_t size, std::align_val_t alignment)
+{
+  bench::countAllocation();
+  size_t bytes = std::max<size_t>(size, 1);
+#ifdef _WIN32
+  void* pointer = _aligned_malloc(bytes, (size_t)alignment);
+#else
+  // aligned_alloc wants the size to be a multiple of the alignment
+  size_t align = std::max((size_t)alignment, sizeof(void*));
+  void* pointer = std::aligned_alloc(align, (bytes + align - 1) & ~(align - 1));
+#endif
+  if (pointer)
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+  _aligned_free(pointer);
+#else
+  std::free(pointer);
+#endif
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+  operator delete(pointer, alignment);
+}
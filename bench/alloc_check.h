@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bench
+{
+struct AllocationCounts
+{
+  // made by tanim, including the standard library on its behalf
+  uint64_t own = 0;
+
+  // made while the WebGPU implementation is on the call stack
+  uint64_t webgpu = 0;
+};
+
+// Counts the heap allocations of the calling thread. tanim_alloc_check
+// replaces the global operator new, so every allocation passes through the
+// counter.
+//
+// Where call stacks are available, allocations with the WebGPU
+// implementation on the stack are counted separately: creating a command
+// encoder or a texture view allocates inside Dawn, which tanim cannot
+// avoid. On Windows the implementation allocates from its own runtime and
+// is never counted.
+class AllocationCounter
+{
+ public:
+  static void start();
+  static AllocationCounts stop();
+
+  // false if the implementation is linked into the executable itself, its
+  // allocations then count as own ones
+  static bool separatesWebGpu();
+
+  // call stack of the first own allocation since start, on stderr
+  static void printFirstOwnAllocation();
+};
+}  // namespace bench
@@ -0,0 +1,210 @@
+#include <webgpu/webgpu_cpp.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string_view>
+
+#include "alloc_check.h"
+#include "animation/clock.h"
+#include "animation/script.h"
+#include "gpu.h"
+#include "graphics/renderer.h"
+#include "scene/preview.h"
+#include "scene/scene.h"
+
+// Runs the preview over an animated scene, the way the window front-end
+// does, and fails if a frame allocates once the scene has looped a few
+// times. The surface is replaced by a texture, and the fixed step clock
+// advances one frame per loop iteration.
+
+constexpr uint32_t targetWidth = 1280;
+constexpr uint32_t targetHeight = 720;
+
+// the scene loops several times during warmup, so every capacity has grown
+// to its steady state size before allocations are counted
+constexpr uint64_t warmupFrames = 600;
+constexpr uint64_t countedFrames = 600;
+
+// room for 18 frames at the default cache scale, fewer than the scene has,
+// so frames are stored, evicted and rendered again on every loop
+constexpr size_t cacheBudget = 16 * 1024 * 1024;
+
+// keyframes, glyph effects, a counting number, a morph and a script, then a
+// second without changes, where the preview idles
+constexpr const char* checkScene = R"({
+  "fps": 60,
+  "duration": 4.0,
+  "texts": [
+    {
+      "text": "Hello, World!",
+      "alignment": "centered",
+      "effect": { "type": "wave", "start": 0.5, "stagger": 0.05 }
+    },
+    { "text": "The quick brown fox", "position": [0.0, -0.5, 0.0] },
+    { "text": "jumps over the lazy dog", "position": [0.0, -0.5, 0.0] },
+    { "text": "Frame", "position": [-1.5, 0.8, 0.0] }
+  ],
+  "numbers": [{ "value": 0, "decimals": 1, "position": [0.0, 0.5, 0.0] }],
+  "animations": [
+    {
+      "text": 0,
+      "property": "rotation",
+      "keys": [
+        { "time": 0.0, "value": [0.0, 0.0, 0.0], "easing": "easeInOut" },
+        { "time": 1.5, "value": [0.0, 0.0, 10.0], "easing": "easeInOut" },
+        { "time": 3.0, "value": [0.0, 0.0, 0.0] }
+      ]
+    },
+    {
+      "number": 0,
+      "property": "value",
+      "keys": [
+        { "time": 0.0, "value": 0, "easing": "easeOut" },
+        { "time": 3.0, "value": 100000 }
+      ]
+    }
+  ],
+  "morphs": [{ "from": 1, "to": 2, "start": 1.0, "duration": 1.0 }],
+  "script": "allocation"
+})";
+
+animation::Script allocationScript(scene::Scene& scene)
+{
+  using namespace std::chrono_literals;
+
+  auto& text = *scene.texts().back();
+  co_await animation::play(animation::fadeIn(text), 0.5s);
+  co_await animation::play(
+    animation::colorTo(text, glm::vec3(1.0f, 0.6f, 0.2f)),
+    1s
+  );
+}
+
+int main(int argc, char** argv)
+{
+  bool hardware = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::string_view(argv[i]) == "--hardware")
+    {
+      hardware = true;
+    }
+    else
+    {
+      std::cerr << "Usage: tanim_alloc_check [--hardware]" << std::endl;
+      return 1;
+    }
+  }
+
+  auto gpu = bench::createGpu(hardware);
+  if (!gpu)
+  {
+    return 1;
+  }
+
+  scene::registerScript("allocation", allocationScript);
+
+  auto format = wgpu::TextureFormat::RGBA8Unorm;
+  auto renderer = graphics::Renderer(gpu->device, gpu->queue, format);
+
+  // like --stats, rows are written in blocks during the counted frames
+  auto statsPath =
+    std::filesystem::temp_directory_path() / "tanim_alloc_check_stats.csv";
+  renderer.stats().record(statsPath);
+  auto description =
+    scene::SceneDescription::parse(nlohmann::json::parse(checkScene));
+  auto scene = scene::Scene(description, renderer);
+  auto clock = animation::Clock::fixedStep(description.frameRate);
+
+  scene::PreviewSettings settings{};
+  settings.width = targetWidth;
+  settings.height = targetHeight;
+  settings.format = format;
+  settings.cacheBudget = cacheBudget;
+  settings.overlay = true;
+  auto preview = scene::Preview(
+    gpu->device,
+    gpu->queue,
+    renderer,
+    scene,
+    clock,
+    description.frameCount,
+    settings
+  );
+
+  wgpu::TextureDescriptor targetDescriptor{};
+  targetDescriptor.label = "Allocation Check Surface Texture";
+  targetDescriptor.dimension = wgpu::TextureDimension::e2D;
+  targetDescriptor.size = {targetWidth, targetHeight, 1};
+  targetDescriptor.mipLevelCount = 1;
+  targetDescriptor.sampleCount = 1;
+  targetDescriptor.format = format;
+  targetDescriptor.usage = wgpu::TextureUsage::RenderAttachment;
+  auto target = gpu->device.CreateTexture(&targetDescriptor);
+  auto targetView = target.CreateView();
+
+  renderer.waitForPipelines();
+
+  uint64_t presentedFrames = 0;
+  auto runFrame = [&]()
+  {
+    auto start = std::chrono::steady_clock::now();
+
+    // idle frames are on the surface already, the window would wait here
+    if (!preview.update())
+    {
+      return;
+    }
+
+    preview.draw(targetView);
+    gpu->instance.ProcessEvents();
+    renderer.stats().endFrame(
+      preview.frameIndex(),
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count()
+    );
+    presentedFrames++;
+
+    // like a presented frame, keeps the queue from growing
+    bench::waitForQueue(gpu->instance, gpu->queue);
+  };
+
+  for (uint64_t i = 0; i < warmupFrames; i++)
+  {
+    runFrame();
+  }
+
+  presentedFrames = 0;
+  bench::AllocationCounter::start();
+  for (uint64_t i = 0; i < countedFrames; i++)
+  {
+    runFrame();
+  }
+  auto counts = bench::AllocationCounter::stop();
+
+  renderer.stats().finishRecording();
+  std::filesystem::remove(statsPath);
+
+  std::cout << "Allocations in " << countedFrames << " frames ("
+            << presentedFrames << " presented) after " << warmupFrames
+            << " warmup frames: " << counts.own;
+  if (bench::AllocationCounter::separatesWebGpu())
+  {
+    std::cout << " (" << counts.webgpu
+              << " more inside the WebGPU implementation, not counted)";
+  }
+  std::cout << std::endl;
+
+  if (counts.own > 0)
+  {
+    std::cerr << "[Allocation Check] The frame loop allocates, first "
+              << "allocation:" << std::endl;
+    bench::AllocationCounter::printFirstOwnAllocation();
+    return 1;
+  }
+  return 0;
+}
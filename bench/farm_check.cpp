@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "video/render_farm.h"
+
+// Runs a render farm of local worker processes, which are this executable
+// started in --farm-worker mode, and checks the stitched output. Workers
+// write the frame numbers instead of rendering, so no GPU is needed.
+//
+// Two faults are injected, each once: the first worker handed the second
+// chunk dies halfway through it, and the first worker handed the fourth
+// chunk stalls past the chunk timeout, so the chunk is duplicated.
+
+constexpr uint64_t frameCount = 30;
+constexpr uint64_t chunkFrameCount = 5;
+constexpr uint32_t workerCount = 3;
+
+constexpr uint64_t crashingChunk = 1;
+constexpr uint64_t stallingChunk = 3;
+constexpr std::chrono::seconds chunkTimeout{1};
+constexpr std::chrono::seconds stallTime{3};
+
+// creates the marker, false if it existed already
+static bool firstTime(const std::filesystem::path& marker)
+{
+  if (std::filesystem::exists(marker))
+  {
+    return false;
+  }
+  std::ofstream(marker).put('\n');
+  return true;
+}
+
+int runWorker(
+  const std::filesystem::path& socketPath,
+  const std::filesystem::path& directory
+)
+{
+  return video::runFarmWorker(
+    socketPath,
+    [&](
+      uint64_t firstFrame,
+      uint64_t count,
+      const std::filesystem::path& output
+    )
+    {
+      bool crash = firstFrame == crashingChunk * chunkFrameCount &&
+                   firstTime(directory / "crashed");
+
+      std::ofstream file(output, std::ios::binary);
+      for (uint64_t frame = firstFrame; frame < firstFrame + count; frame++)
+      {
+        if (crash && frame == firstFrame + count / 2)
+        {
+          file.flush();
+          std::_Exit(1);
+        }
+        file.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+      }
+      file.flush();
+
+      if (firstFrame == stallingChunk * chunkFrameCount &&
+          firstTime(directory / "stalled"))
+      {
+        std::this_thread::sleep_for(stallTime);
+      }
+      return file.good();
+    }
+  );
+}
+
+bool checkOutput(const std::filesystem::path& directory)
+{
+  std::ifstream file(directory / "output.bin", std::ios::binary);
+  for (uint64_t expected = 0; expected < frameCount; expected++)
+  {
+    uint64_t frame = 0;
+    if (!file.read(reinterpret_cast<char*>(&frame), sizeof(frame)) ||
+        frame != expected)
+    {
+      std::cerr << "[Farm Check] Frame " << expected << " is missing or out "
+                << "of order in the stitched output" << std::endl;
+      return false;
+    }
+  }
+
+  if (file.peek() != std::ifstream::traits_type::eof())
+  {
+    std::cerr << "[Farm Check] The stitched output has more than "
+              << frameCount << " frames" << std::endl;
+    return false;
+  }
+
+  for (const auto& entry : std::filesystem::directory_iterator(directory))
+  {
+    if (entry.path().filename().string().find(".part") != std::string::npos)
+    {
+      std::cerr << "[Farm Check] Part file left behind: "
+                << entry.path().string() << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int runCoordinator(const char* executable)
+{
+  auto directory =
+    std::filesystem::temp_directory_path() /
+    ("tanim_farm_check_" +
+     std::to_string(
+       std::chrono::steady_clock::now().time_since_epoch().count()
+     ));
+  std::filesystem::create_directories(directory);
+
+  video::FarmOptions options{};
+  options.socketPath = directory / "farm.sock";
+  options.outputPath = directory / "output.bin";
+  options.frameCount = frameCount;
+  options.chunkFrameCount = chunkFrameCount;
+  options.workerCount = workerCount;
+  options.workerCommand = {executable, "--directory", directory.string()};
+  options.chunkTimeout = chunkTimeout;
+
+  // the coordinator cleans up behind stalled duplicates once it is gone
+  int result = 0;
+  {
+    auto coordinator = video::FarmCoordinator(options);
+    result = coordinator.run();
+  }
+
+  bool succeeded = result == 0 && checkOutput(directory);
+  if (result != 0)
+  {
+    std::cerr << "[Farm Check] The coordinator failed" << std::endl;
+  }
+
+  std::filesystem::remove_all(directory);
+
+  std::cout << "Farm of " << workerCount << " workers, " << frameCount
+            << " frames: " << (succeeded ? "passed" : "failed") << std::endl;
+  return succeeded ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+  std::optional<std::filesystem::path> socketPath;
+  std::optional<std::filesystem::path> directory;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string_view argument = argv[i];
+    if (argument == "--farm-worker" && i + 1 < argc)
+    {
+      socketPath = argv[++i];
+    }
+    else if (argument == "--directory" && i + 1 < argc)
+    {
+      directory = argv[++i];
+    }
+    else
+    {
+      std::cerr << "Usage: tanim_farm_check" << std::endl;
+      return 1;
+    }
+  }
+
+  if (socketPath && directory)
+  {
+    return runWorker(*socketPath, *directory);
+  }
+  return runCoordinator(argv[0]);
+}
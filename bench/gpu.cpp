@@ -0,0 +1,126 @@
+#include "gpu.h"
+
+#include <dawn/webgpu_cpp_print.h>
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace bench
+{
+std::optional<Gpu> createGpu(bool hardware)
+{
+  Gpu gpu{};
+
+  wgpu::InstanceDescriptor instanceDescriptor{};
+  instanceDescriptor.features.timedWaitAnyEnable = true;
+  gpu.instance = wgpu::CreateInstance(&instanceDescriptor);
+  if (!gpu.instance)
+  {
+    std::cerr << "[WebGPU] Could not create Instance" << std::endl;
+    return std::nullopt;
+  }
+
+  wgpu::RequestAdapterOptions adapterOptions{};
+  adapterOptions.forceFallbackAdapter = !hardware;
+
+  gpu.instance.WaitAny(
+    gpu.instance.RequestAdapter(
+      &adapterOptions,
+      wgpu::CallbackMode::WaitAnyOnly,
+      [](
+        wgpu::RequestAdapterStatus status,
+        wgpu::Adapter adapter,
+        wgpu::StringView message,
+        wgpu::Adapter* outAdapter
+      )
+      {
+        *outAdapter = adapter;
+        if (!adapter)
+        {
+          std::cerr << "[WebGPU] Failed to get Adapter: " << message
+                    << std::endl;
+        }
+      },
+      &gpu.adapter
+    ),
+    UINT64_MAX
+  );
+  if (!gpu.adapter)
+  {
+    std::cerr << "[WebGPU] Could not request Adapter" << std::endl;
+    return std::nullopt;
+  }
+
+  // optional, the renderer only measures GPU pass timings with it
+  std::vector<wgpu::FeatureName> requiredFeatures;
+  if (gpu.adapter.HasFeature(wgpu::FeatureName::TimestampQuery))
+  {
+    requiredFeatures.push_back(wgpu::FeatureName::TimestampQuery);
+  }
+
+  wgpu::DeviceDescriptor deviceDescriptor{};
+  deviceDescriptor.label = "Bench Device";
+  deviceDescriptor.requiredFeatureCount = requiredFeatures.size();
+  deviceDescriptor.requiredFeatures = requiredFeatures.data();
+  deviceDescriptor.defaultQueue.label = "Bench Queue";
+  deviceDescriptor.SetUncapturedErrorCallback(
+    [](
+      const wgpu::Device& device,
+      wgpu::ErrorType type,
+      wgpu::StringView message
+    )
+    {
+      std::cerr << "[WebGPU] Device Uncaptured (" << type << "): " << message
+                << std::endl;
+    }
+  );
+
+  gpu.instance.WaitAny(
+    gpu.adapter.RequestDevice(
+      &deviceDescriptor,
+      wgpu::CallbackMode::WaitAnyOnly,
+      [](
+        wgpu::RequestDeviceStatus status,
+        wgpu::Device device,
+        wgpu::StringView message,
+        wgpu::Device* outDevice
+      )
+      {
+        *outDevice = device;
+        if (!device)
+        {
+          std::cerr << "[WebGPU] Failed to get Device: " << message
+                    << std::endl;
+        }
+      },
+      &gpu.device
+    ),
+    UINT64_MAX
+  );
+  if (!gpu.device)
+  {
+    return std::nullopt;
+  }
+
+  gpu.queue = gpu.device.GetQueue();
+
+  wgpu::AdapterInfo adapterInfo{};
+  gpu.adapter.GetInfo(&adapterInfo);
+  std::cout << "Adapter: " << adapterInfo.device << " ("
+            << adapterInfo.backendType << ")" << std::endl;
+
+  return gpu;
+}
+
+void waitForQueue(const wgpu::Instance& instance, const wgpu::Queue& queue)
+{
+  instance.WaitAny(
+    queue.OnSubmittedWorkDone(
+      wgpu::CallbackMode::WaitAnyOnly,
+      [](wgpu::QueueWorkDoneStatus status) {}
+    ),
+    UINT64_MAX
+  );
+}
+}  // namespace bench
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <optional>
+
+namespace bench
+{
+struct Gpu
+{
+  wgpu::Instance instance;
+  wgpu::Adapter adapter;
+  wgpu::Device device;
+  wgpu::Queue queue;
+};
+
+// The software adapter keeps results comparable between machines, unless
+// hardware is asked for. Errors are printed, nullopt if there is no device.
+std::optional<Gpu> createGpu(bool hardware);
+
+void waitForQueue(const wgpu::Instance& instance, const wgpu::Queue& queue);
+}  // namespace bench
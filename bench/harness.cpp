@@ -0,0 +1,124 @@
+#include "harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace bench
+{
+Harness::Harness(const Settings& settings) : _settings(settings)
+{
+}
+
+void Harness::run(const std::string& name, const Body& body)
+{
+  if (name.find(_settings.filter) == std::string::npos)
+  {
+    return;
+  }
+
+  // double the iteration count until a repetition is long enough to be
+  // measured reliably, this also serves as the first warmup
+  uint64_t iterations = 1;
+  while (measure(body, iterations) < _settings.minRepetitionTime &&
+         iterations < (1ull << 30))
+  {
+    iterations *= 2;
+  }
+
+  for (uint32_t i = 0; i < _settings.warmup; i++)
+  {
+    measure(body, iterations);
+  }
+
+  std::vector<double> times(std::max(_settings.repetitions, 1u));
+  for (auto& time : times)
+  {
+    time = measure(body, iterations) * 1e9 / (double)iterations;
+  }
+  std::sort(times.begin(), times.end());
+
+  auto percentile = [&](double p)
+  {
+    size_t rank = (size_t)std::ceil(p * (double)times.size());
+    return times[std::clamp<size_t>(rank, 1, times.size()) - 1];
+  };
+
+  Result result{};
+  result.name = name;
+  result.iterations = iterations;
+  result.repetitions = (uint32_t)times.size();
+  result.median = percentile(0.5);
+  result.p99 = percentile(0.99);
+  result.mean =
+    std::accumulate(times.begin(), times.end(), 0.0) / (double)times.size();
+  result.min = times.front();
+
+  std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(1)
+            << result.median << " ns" << std::setw(14) << result.p99 << " ns"
+            << std::setw(12) << iterations << std::endl;
+
+  _results.push_back(std::move(result));
+}
+
+nlohmann::json Harness::toJson() const
+{
+  auto benchmarks = nlohmann::json::array();
+  for (const auto& result : _results)
+  {
+    benchmarks.push_back({
+      {"name", result.name},
+      {"iterations", result.iterations},
+      {"repetitions", result.repetitions},
+      {"median_ns", result.median},
+      {"p99_ns", result.p99},
+      {"mean_ns", result.mean},
+      {"min_ns", result.min},
+    });
+  }
+  return {{"benchmarks", benchmarks}};
+}
+
+bool Harness::compare(const nlohmann::json& baseline, double threshold) const
+{
+  bool passed = true;
+  for (const auto& result : _results)
+  {
+    auto it = std::find_if(
+      baseline["benchmarks"].begin(),
+      baseline["benchmarks"].end(),
+      [&](const nlohmann::json& entry) { return entry["name"] == result.name; }
+    );
+    if (it == baseline["benchmarks"].end())
+    {
+      continue;
+    }
+
+    double previous = (*it)["median_ns"];
+    double change = result.median / previous - 1.0;
+    bool regressed = change > threshold;
+    passed = passed && !regressed;
+
+    std::cout << std::left << std::setw(40) << result.name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << previous << " ns -> " << result.median << " ns"
+              << std::showpos << std::setw(10) << change * 100.0 << "%"
+              << std::noshowpos << (regressed ? "  REGRESSION" : "")
+              << std::endl;
+  }
+  return passed;
+}
+
+double Harness::measure(const Body& body, uint64_t iterations) const
+{
+  auto start = std::chrono::steady_clock::now();
+  body(iterations);
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+}  // namespace bench
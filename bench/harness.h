@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench
+{
+struct Settings
+{
+  // untimed repetitions before measuring
+  uint32_t warmup = 3;
+  uint32_t repetitions = 30;
+
+  // every repetition runs the body often enough to take at least this long
+  double minRepetitionTime = 0.02;
+
+  // only benchmarks whose name contains the filter are run
+  std::string filter;
+};
+
+struct Result
+{
+  std::string name;
+  uint64_t iterations = 0;
+  uint32_t repetitions = 0;
+
+  // nanoseconds per iteration over all repetitions
+  double median = 0.0;
+  double p99 = 0.0;
+  double mean = 0.0;
+  double min = 0.0;
+};
+
+// Runs a body taking an iteration count, so the loop itself is part of the
+// benchmark and no indirect call is measured per iteration.
+using Body = std::function<void(uint64_t iterations)>;
+
+// Minimal benchmark harness: calibrates the iteration count of every
+// benchmark to the minimum repetition time, runs warmup repetitions and
+// reports the median and p99 of the timed ones.
+class Harness
+{
+ public:
+  Harness(const Settings& settings);
+  ~Harness() = default;
+
+  void run(const std::string& name, const Body& body);
+
+  const std::vector<Result>& results() const
+  {
+    return _results;
+  }
+
+  nlohmann::json toJson() const;
+
+  // prints the change against a previous run, returns false if any
+  // benchmark got slower than the threshold (0.1 = 10%)
+  bool compare(const nlohmann::json& baseline, double threshold) const;
+
+ private:
+  double measure(const Body& body, uint64_t iterations) const;
+
+ private:
+  Settings _settings;
+  std::vector<Result> _results;
+};
+
+// keeps the compiler from optimizing away a value which is otherwise unused
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+}  // namespace bench
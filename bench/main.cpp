@@ -0,0 +1,374 @@
+#include <webgpu/webgpu_cpp.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gpu.h"
+#include "graphics/camera.h"
+#include "graphics/font.h"
+#include "graphics/frame_data.h"
+#include "graphics/renderer.h"
+#include "graphics/text.h"
+#include "harness.h"
+#include "util/profiler.h"
+#include "util/transform.h"
+
+// fonts are loaded relative to the working directory, so the benchmarks run
+// from the directory the assets are copied to
+constexpr const char* fontPath = "assets/fonts/ARIALBD.TTF-msdf";
+
+constexpr uint32_t targetWidth = 1280;
+constexpr uint32_t targetHeight = 720;
+
+struct Options
+{
+  bench::Settings settings;
+  std::optional<std::filesystem::path> jsonPath;
+  std::optional<std::filesystem::path> baselinePath;
+  double threshold = 0.1;
+  bool hardware = false;
+};
+
+std::optional<Options> parseOptions(int argc, char** argv)
+{
+  Options options{};
+  for (int i = 1; i < argc; i++)
+  {
+    std::string_view argument = argv[i];
+    if (argument == "--json" && i + 1 < argc)
+    {
+      options.jsonPath = argv[++i];
+    }
+    else if (argument == "--baseline" && i + 1 < argc)
+    {
+      options.baselinePath = argv[++i];
+    }
+    else if (argument == "--threshold" && i + 1 < argc)
+    {
+      options.threshold = std::stod(argv[++i]) / 100.0;
+    }
+    else if (argument == "--filter" && i + 1 < argc)
+    {
+      options.settings.filter = argv[++i];
+    }
+    else if (argument == "--repetitions" && i + 1 < argc)
+    {
+      options.settings.repetitions = (uint32_t)std::stoul(argv[++i]);
+    }
+    else if (argument == "--warmup" && i + 1 < argc)
+    {
+      options.settings.warmup = (uint32_t)std::stoul(argv[++i]);
+    }
+    else if (argument == "--hardware")
+    {
+      options.hardware = true;
+    }
+    else
+    {
+      std::cerr << "Usage: tanim_bench [--filter <name>] "
+                   "[--repetitions <count>] [--warmup <count>]\n"
+                   "                   [--json <results.json>] "
+                   "[--baseline <results.json>]\n"
+                   "                   [--threshold <percent>] [--hardware]"
+                << std::endl;
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
+// sample texts of different lengths and character mixes, the atlas only
+// contains printable ascii
+std::vector<std::pair<std::string, std::string>> sampleTexts()
+{
+  const std::string sentence = "The quick brown fox jumps over the lazy dog.";
+
+  std::string paragraph;
+  for (int i = 0; i < 10; i++)
+  {
+    paragraph += sentence + " ";
+  }
+
+  std::string page;
+  for (int i = 0; i < 40; i++)
+  {
+    page += sentence + " 0123456789\n";
+  }
+
+  std::string symbols;
+  for (int i = 0; i < 8; i++)
+  {
+    symbols += "{[(<$1,234.56>)]} +-*/=%&#@!?;:'\"|\\~^_` ";
+  }
+
+  return {
+    {"short", "Hello, World!"},
+    {"sentence", sentence},
+    {"paragraph", paragraph},
+    {"page", page},
+    {"symbols", symbols},
+  };
+}
+
+void benchFont(
+  bench::Harness& harness,
+  const wgpu::Instance& instance,
+  const wgpu::Device& device,
+  const wgpu::Queue& queue
+)
+{
+  harness.run(
+    "font/construct",
+    [&](uint64_t iterations)
+    {
+      for (uint64_t i = 0; i < iterations; i++)
+      {
+        auto font = graphics::Font(device, queue, fontPath);
+        bench::doNotOptimize(font);
+      }
+      bench::waitForQueue(instance, queue);
+    }
+  );
+}
+
+void benchTextLayout(bench::Harness& harness, const graphics::Font& font)
+{
+  for (const auto& [name, sample] : sampleTexts())
+  {
+    // setText only lays out again if the text differs, so two texts which
+    // differ in their last character are alternated
+    std::string alternate = sample;
+    alternate.back() = alternate.back() == '.' ? '!' : '.';
+
+    auto text = graphics::Text(sample, font);
+    harness.run(
+      "text/layout/" + name,
+      [&](uint64_t iterations)
+      {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+          text.setText(i % 2 == 0 ? alternate : sample);
+          bench::doNotOptimize(text.width());
+        }
+      }
+    );
+  }
+}
+
+void benchTransforms(bench::Harness& harness, const graphics::Font& font)
+{
+  constexpr size_t flatCount = 1000;
+  constexpr size_t deepCount = 64;
+
+  {
+    util::Transform root;
+    std::vector<util::Transform> children(flatCount);
+    for (auto& child : children)
+    {
+      child.setParent(&root);
+    }
+
+    harness.run(
+      "transform/flat/1000",
+      [&](uint64_t iterations)
+      {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+          root.setPosition(glm::vec3((float)(i % 2), 0.0f, 0.0f));
+          for (auto& child : children)
+          {
+            bench::doNotOptimize(child.matrix());
+          }
+        }
+      }
+    );
+  }
+
+  {
+    std::vector<util::Transform> chain(deepCount);
+    for (size_t i = 1; i < chain.size(); i++)
+    {
+      chain[i].setParent(&chain[i - 1]);
+      chain[i].setPosition(glm::vec3(0.0f, 0.1f, 0.0f));
+    }
+
+    harness.run(
+      "transform/deep/64",
+      [&](uint64_t iterations)
+      {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+          chain.front().setPosition(glm::vec3((float)(i % 2), 0.0f, 0.0f));
+          bench::doNotOptimize(chain.back().matrix());
+        }
+      }
+    );
+  }
+
+  // the per frame path of a moving text: its glyphs recompute their
+  // matrices while the frame is filled
+  {
+    auto text = graphics::Text(sampleTexts()[2].second, font);
+    auto frame = graphics::FrameData();
+
+    harness.run(
+      "transform/text/paragraph",
+      [&](uint64_t iterations)
+      {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+          text.transform.setPosition(glm::vec3((float)(i % 2), 0.0f, 0.0f));
+          frame.reset(i, 0.0);
+          frame.addText(text);
+          bench::doNotOptimize(frame.characters.data());
+        }
+      }
+    );
+  }
+}
+
+void benchProfiler(bench::Harness& harness)
+{
+  // zones are used directly, so the cost is measured even in builds without
+  // TANIM_PROFILE where the macros are empty
+  harness.run(
+    "profiler/zone/idle",
+    [](uint64_t iterations)
+    {
+      for (uint64_t i = 0; i < iterations; i++)
+      {
+        util::ProfileZone zone("Bench Zone");
+      }
+    }
+  );
+
+  util::Profiler::capture(0, 1);
+  util::Profiler::beginFrame(0);
+  harness.run(
+    "profiler/zone/recording",
+    [](uint64_t iterations)
+    {
+      for (uint64_t i = 0; i < iterations; i++)
+      {
+        util::ProfileZone zone("Bench Zone");
+      }
+    }
+  );
+  util::Profiler::beginFrame(1);
+}
+
+void benchRenderer(
+  bench::Harness& harness,
+  const wgpu::Instance& instance,
+  const wgpu::Device& device,
+  const wgpu::Queue& queue
+)
+{
+  auto renderer =
+    graphics::Renderer(device, queue, wgpu::TextureFormat::RGBA8Unorm);
+  const auto& font = renderer.font(fontPath);
+  auto camera = graphics::Camera();
+
+  wgpu::TextureDescriptor targetDescriptor{};
+  targetDescriptor.label = "Bench Render Target";
+  targetDescriptor.dimension = wgpu::TextureDimension::e2D;
+  targetDescriptor.size = {targetWidth, targetHeight, 1};
+  targetDescriptor.mipLevelCount = 1;
+  targetDescriptor.sampleCount = 1;
+  targetDescriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+  targetDescriptor.usage = wgpu::TextureUsage::RenderAttachment;
+  auto target = device.CreateTexture(&targetDescriptor);
+  auto targetView = target.CreateView();
+
+  for (size_t count : {1, 16, 64})
+  {
+    std::vector<std::unique_ptr<graphics::Text>> texts;
+    for (size_t i = 0; i < count; i++)
+    {
+      auto& text = texts.emplace_back(
+        std::make_unique<graphics::Text>(sampleTexts()[1].second, font)
+      );
+      text->transform.setPosition(
+        glm::vec3(-2.0f, 1.5f - 0.05f * (float)i, 0.0f)
+      );
+    }
+
+    // submission is measured together with the GPU work, so the queue does
+    // not grow without bound on fast CPUs
+    harness.run(
+      "renderer/drawText+flush/" + std::to_string(count),
+      [&](uint64_t iterations)
+      {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+          for (auto& text : texts)
+          {
+            renderer.drawText(*text, camera);
+          }
+          renderer.flush(targetView);
+        }
+        bench::waitForQueue(instance, queue);
+      }
+    );
+  }
+}
+
+int main(int argc, char** argv)
+{
+  auto options = parseOptions(argc, argv);
+  if (!options)
+  {
+    return 1;
+  }
+
+  auto gpu = bench::createGpu(options->hardware);
+  if (!gpu)
+  {
+    return 1;
+  }
+  auto& [instance, adapter, device, queue] = *gpu;
+
+  auto harness = bench::Harness(options->settings);
+  auto font = graphics::Font(device, queue, fontPath);
+
+  benchFont(harness, instance, device, queue);
+  benchTextLayout(harness, font);
+  benchTransforms(harness, font);
+  benchProfiler(harness);
+  benchRenderer(harness, instance, device, queue);
+
+  auto results = harness.toJson();
+  wgpu::AdapterInfo adapterInfo{};
+  adapter.GetInfo(&adapterInfo);
+  results["adapter"] = std::string(adapterInfo.device);
+
+  if (options->jsonPath)
+  {
+    std::ofstream file(*options->jsonPath);
+    file << results.dump(2) << std::endl;
+  }
+
+  if (options->baselinePath)
+  {
+    std::ifstream file(*options->baselinePath);
+    if (!file.is_open())
+    {
+      std::cerr << "[Bench] Could not open " << options->baselinePath->string()
+                << std::endl;
+      return 1;
+    }
+
+    std::cout << std::endl;
+    if (!harness.compare(nlohmann::json::parse(file), options->threshold))
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
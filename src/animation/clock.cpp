@@ -0,0 +1,74 @@
+#include "clock.h"
+
+#include <stdexcept>
+
+namespace animation
+{
+Clock Clock::realTime(uint32_t frameRate)
+{
+  if (frameRate == 0)
+  {
+    throw std::invalid_argument("Clock frame rate must not be zero");
+  }
+  return Clock(ClockMode::RealTime, frameRate);
+}
+
+Clock Clock::fixedStep(uint32_t frameRate)
+{
+  if (frameRate == 0)
+  {
+    throw std::invalid_argument("Clock frame rate must not be zero");
+  }
+  return Clock(ClockMode::FixedStep, frameRate);
+}
+
+Clock::Clock(ClockMode mode, uint32_t frameRate)
+  : _mode(mode), _frameRate(frameRate), _start(std::chrono::steady_clock::now())
+{
+}
+
+void Clock::tick()
+{
+  _frame++;
+
+  double time = 0.0;
+  switch (_mode)
+  {
+    case ClockMode::RealTime:
+    {
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - _start;
+      time = elapsed.count();
+      break;
+    }
+
+    case ClockMode::FixedStep:
+      time = frameTime(_frame);
+      break;
+  }
+
+  _deltaTime = time - _time;
+  _time = time;
+}
+
+void Clock::seek(uint64_t frame)
+{
+  _frame = frame;
+  _deltaTime = 0.0;
+
+  switch (_mode)
+  {
+    case ClockMode::RealTime:
+      _time = frameTime(frame);
+      _start = std::chrono::steady_clock::now() -
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                 std::chrono::duration<double>(_time)
+               );
+      break;
+
+    case ClockMode::FixedStep:
+      _time = frameTime(frame);
+      break;
+  }
+}
+}  // namespace animation
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace animation
+{
+enum class ClockMode
+{
+  RealTime,
+  FixedStep,
+};
+
+// Drives animation time. Real time clocks follow the steady clock for
+// interactive previews, fixed step clocks derive the time from the frame
+// index only, so offline renders are frame-exact and reproducible.
+class Clock
+{
+ public:
+  static Clock realTime(uint32_t frameRate = 60);
+  static Clock fixedStep(uint32_t frameRate);
+
+  ~Clock() = default;
+
+  void tick();
+
+  void seek(uint64_t frame);
+
+  ClockMode mode() const
+  {
+    return _mode;
+  }
+
+  uint32_t frameRate() const
+  {
+    return _frameRate;
+  }
+
+  uint64_t frame() const
+  {
+    return _frame;
+  }
+
+  double time() const
+  {
+    return _time;
+  }
+
+  double deltaTime() const
+  {
+    return _deltaTime;
+  }
+
+  double frameTime(uint64_t frame) const
+  {
+    return (double)frame / (double)_frameRate;
+  }
+
+ private:
+  Clock(ClockMode mode, uint32_t frameRate);
+
+ private:
+  ClockMode _mode;
+  uint32_t _frameRate;
+
+  uint64_t _frame = 0;
+  double _time = 0.0;
+  double _deltaTime = 0.0;
+
+  std::chrono::steady_clock::time_point _start;
+};
+}  // namespace animation
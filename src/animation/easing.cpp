@@ -0,0 +1,29 @@
+#include "easing.h"
+
+namespace animation
+{
+float ease(Easing easing, float t)
+{
+  switch (easing)
+  {
+    case Easing::Linear:
+      return t;
+
+    case Easing::Step:
+      return t < 1.0f ? 0.0f : 1.0f;
+
+    case Easing::EaseIn:
+      return t * t * t;
+
+    case Easing::EaseOut:
+    {
+      float u = 1.0f - t;
+      return 1.0f - u * u * u;
+    }
+
+    case Easing::EaseInOut:
+      return t * t * (3.0f - 2.0f * t);
+  }
+  return t;
+}
+}  // namespace animation
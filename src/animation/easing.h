@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace animation
+{
+// The values are shared with the text shader, which evaluates the same
+// curves for per-glyph effects.
+enum class Easing : uint8_t
+{
+  Linear,
+  Step,
+  EaseIn,
+  EaseOut,
+  EaseInOut,
+};
+
+float ease(Easing easing, float t);
+}  // namespace animation
@@ -0,0 +1,271 @@
+#include "script.h"
+
+#include <cstddef>
+#include <new>
+
+namespace animation
+{
+// coroutine frames remember which allocator they came from, the header keeps
+// the frame itself aligned to 16 bytes
+struct FrameHeader
+{
+  util::PoolAllocator* allocator;
+};
+constexpr size_t frameHeaderSize = 16;
+
+static thread_local Scheduler* currentScheduler = nullptr;
+
+void* Script::promise_type::operator new(size_t size)
+{
+  auto* scheduler = Scheduler::current();
+  auto* allocator = scheduler ? &scheduler->allocator() : nullptr;
+
+  size_t blockSize = size + frameHeaderSize;
+  void* block =
+    allocator ? allocator->allocate(blockSize) : ::operator new(blockSize);
+  static_cast<FrameHeader*>(block)->allocator = allocator;
+  return static_cast<std::byte*>(block) + frameHeaderSize;
+}
+
+void Script::promise_type::operator delete(void* pointer, size_t size)
+{
+  void* block = static_cast<std::byte*>(pointer) - frameHeaderSize;
+  auto* allocator = static_cast<FrameHeader*>(block)->allocator;
+  if (allocator)
+  {
+    allocator->deallocate(block, size + frameHeaderSize);
+  }
+  else
+  {
+    ::operator delete(block);
+  }
+}
+
+std::coroutine_handle<> Script::FinalAwaiter::await_suspend(Handle handle
+) noexcept
+{
+  auto& promise = handle.promise();
+  if (promise.continuation)
+  {
+    return promise.continuation;
+  }
+
+  if (promise.scheduler)
+  {
+    promise.scheduler->_finished.push_back(handle);
+  }
+  return std::noop_coroutine();
+}
+
+Script::Script(Script&& other) noexcept : _handle(other.release())
+{
+}
+
+Script& Script::operator=(Script&& other) noexcept
+{
+  if (this != &other)
+  {
+    if (_handle)
+    {
+      _handle.destroy();
+    }
+    _handle = other.release();
+  }
+  return *this;
+}
+
+Script::~Script()
+{
+  if (_handle)
+  {
+    _handle.destroy();
+  }
+}
+
+Tween moveTo(util::Transform& transform, const glm::vec3& position)
+{
+  return {
+    .target = &transform,
+    .property = TrackProperty::Position,
+    .to = glm::vec4(position, 0.0f),
+  };
+}
+
+Tween rotateTo(util::Transform& transform, const glm::quat& rotation)
+{
+  return {
+    .target = &transform,
+    .property = TrackProperty::Rotation,
+    .to = glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w),
+  };
+}
+
+Tween scaleTo(util::Transform& transform, const glm::vec3& scale)
+{
+  return {
+    .target = &transform,
+    .property = TrackProperty::Scale,
+    .to = glm::vec4(scale, 0.0f),
+  };
+}
+
+Tween colorTo(graphics::Text& text, const glm::vec3& color)
+{
+  return {
+    .target = &text,
+    .property = TrackProperty::Color,
+    .to = glm::vec4(color, 0.0f),
+  };
+}
+
+Tween fadeIn(graphics::Text& text)
+{
+  return {
+    .target = &text,
+    .property = TrackProperty::Opacity,
+    .from = glm::vec4(0.0f),
+    .to = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
+  };
+}
+
+Tween fadeOut(graphics::Text& text)
+{
+  return {
+    .target = &text,
+    .property = TrackProperty::Opacity,
+    .to = glm::vec4(0.0f),
+  };
+}
+
+Tween countTo(graphics::NumberText& number, double value)
+{
+  return {
+    .target = &number,
+    .property = TrackProperty::Value,
+    .to = glm::vec4((float)value, 0.0f, 0.0f, 0.0f),
+  };
+}
+
+Scheduler::Scheduler(Timeline& timeline) : _timeline(timeline)
+{
+}
+
+Scheduler::~Scheduler()
+{
+  // nested scripts are owned by the frames of their callers
+  for (auto handle : _scripts)
+  {
+    handle.destroy();
+  }
+}
+
+void Scheduler::spawn(Script script)
+{
+  auto handle = script.release();
+  if (!handle)
+  {
+    return;
+  }
+
+  handle.promise().scheduler = this;
+  handle.promise().rootIndex = _scripts.size();
+  _scripts.push_back(handle);
+  schedule(handle, _time);
+}
+
+void Scheduler::update(double time)
+{
+  auto* previous = setCurrent(this);
+  while (!_wakeups.empty() && _wakeups.top().time <= time)
+  {
+    auto wakeup = _wakeups.top();
+    _wakeups.pop();
+
+    _time = wakeup.time;
+    wakeup.handle.resume();
+  }
+  _time = std::max(_time, time);
+  setCurrent(previous);
+
+  std::exception_ptr exception;
+  for (auto handle : _finished)
+  {
+    if (!exception)
+    {
+      exception = handle.promise().exception;
+    }
+    finish(handle);
+  }
+  _finished.clear();
+
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+void Scheduler::play(const Tween& tween, Seconds duration)
+{
+  size_t track = std::visit(
+    [&](auto* target) { return _timeline.track(*target, tween.property); },
+    tween.target
+  );
+
+  glm::vec4 from = tween.from ? *tween.from : _timeline.valueAt(track, _time);
+  _timeline.addKey(track, (float)_time, from, tween.easing);
+  _timeline.addKey(
+    track,
+    (float)(_time + duration.count()),
+    tween.to,
+    tween.easing
+  );
+}
+
+void Scheduler::schedule(std::coroutine_handle<> handle, double time)
+{
+  _wakeups.push({time, _sequence++, handle});
+}
+
+Scheduler* Scheduler::current()
+{
+  return currentScheduler;
+}
+
+Scheduler* Scheduler::setCurrent(Scheduler* scheduler)
+{
+  return std::exchange(currentScheduler, scheduler);
+}
+
+void Scheduler::finish(Script::Handle handle)
+{
+  size_t index = handle.promise().rootIndex;
+  _scripts[index] = _scripts.back();
+  _scripts[index].promise().rootIndex = index;
+  _scripts.pop_back();
+
+  handle.destroy();
+}
+
+void WaitAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+  auto* scheduler = Scheduler::current();
+  scheduler->schedule(handle, scheduler->time() + duration.count());
+}
+
+void PlayAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+  auto* scheduler = Scheduler::current();
+  scheduler->play(tween, duration);
+  scheduler->schedule(handle, scheduler->time() + duration.count());
+}
+
+WaitAwaiter wait(Seconds duration)
+{
+  return {duration};
+}
+
+PlayAwaiter play(const Tween& tween, Seconds duration)
+{
+  return {tween, duration};
+}
+}  // namespace animation
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <variant>
+#include <vector>
+
+#include "animation/timeline.h"
+#include "graphics/camera.h"
+#include "graphics/number_text.h"
+#include "graphics/text.h"
+#include "util/pool_allocator.h"
+#include "util/transform.h"
+
+namespace animation
+{
+using Seconds = std::chrono::duration<double>;
+
+class Scheduler;
+
+// Coroutine type of animation scripts:
+//
+//   Script intro(Text& text)
+//   {
+//     co_await play(fadeIn(text), 1s);
+//     co_await wait(0.5s);
+//   }
+//
+// Scripts start suspended and are run by a Scheduler. Awaiting another
+// script runs it to completion before the caller continues. Frames created
+// while a scheduler is active come from its pool allocator.
+class Script
+{
+ public:
+  struct promise_type;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  struct FinalAwaiter
+  {
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    std::coroutine_handle<> await_suspend(Handle handle) noexcept;
+
+    void await_resume() const noexcept
+    {
+    }
+  };
+
+  struct promise_type
+  {
+    Script get_return_object()
+    {
+      return Script(Handle::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+      return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+      return {};
+    }
+
+    void return_void() const noexcept
+    {
+    }
+
+    void unhandled_exception()
+    {
+      exception = std::current_exception();
+    }
+
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    Scheduler* scheduler = nullptr;
+    size_t rootIndex = 0;
+  };
+
+  Script(Script&& other) noexcept;
+  Script& operator=(Script&& other) noexcept;
+  ~Script();
+
+  Script(const Script&) = delete;
+  Script& operator=(const Script&) = delete;
+
+  bool await_ready() const noexcept
+  {
+    return !_handle || _handle.done();
+  }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller
+  ) noexcept
+  {
+    _handle.promise().continuation = caller;
+    return _handle;
+  }
+
+  void await_resume() const
+  {
+    if (_handle && _handle.promise().exception)
+    {
+      std::rethrow_exception(_handle.promise().exception);
+    }
+  }
+
+ private:
+  explicit Script(Handle handle) : _handle(handle)
+  {
+  }
+
+  Handle release()
+  {
+    return std::exchange(_handle, nullptr);
+  }
+
+ private:
+  Handle _handle;
+
+  friend class Scheduler;
+};
+
+// A property change played over a duration, the start value defaults to
+// the value of the property when the tween starts.
+struct Tween
+{
+  std::variant<
+    util::Transform*,
+    graphics::Text*,
+    graphics::Camera*,
+    graphics::NumberText*>
+    target;
+  TrackProperty property;
+  std::optional<glm::vec4> from;
+  glm::vec4 to;
+  Easing easing = Easing::EaseInOut;
+};
+
+Tween moveTo(util::Transform& transform, const glm::vec3& position);
+Tween rotateTo(util::Transform& transform, const glm::quat& rotation);
+Tween scaleTo(util::Transform& transform, const glm::vec3& scale);
+Tween colorTo(graphics::Text& text, const glm::vec3& color);
+Tween fadeIn(graphics::Text& text);
+Tween fadeOut(graphics::Text& text);
+Tween countTo(graphics::NumberText& number, double value);
+
+// Resumes scripts when the animation time reaches their wake up time. Waiting
+// scripts sit in a priority queue, an update only touches scripts which are
+// due. Every script observes the exact time it asked to wake up at, so the
+// resulting animation does not depend on the frame rate.
+class Scheduler
+{
+ public:
+  Scheduler(Timeline& timeline);
+  ~Scheduler();
+
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  void spawn(Script script);
+
+  // creates the script with this scheduler active, so its frame is pooled
+  template <typename F, typename... Args>
+  void spawn(F&& function, Args&&... args)
+  {
+    auto* previous = setCurrent(this);
+    auto script =
+      std::invoke(std::forward<F>(function), std::forward<Args>(args)...);
+    setCurrent(previous);
+    spawn(std::move(script));
+  }
+
+  void update(double time);
+
+  // adds the keys of the tween to the timeline without waiting for it
+  void play(const Tween& tween, Seconds duration);
+
+  void schedule(std::coroutine_handle<> handle, double time);
+
+  double time() const
+  {
+    return _time;
+  }
+
+  // time at which the next waiting script resumes, infinity if none waits
+  double nextWakeup() const
+  {
+    return _wakeups.empty() ? std::numeric_limits<double>::infinity()
+                            : _wakeups.top().time;
+  }
+
+  Timeline& timeline()
+  {
+    return _timeline;
+  }
+
+  size_t scriptCount() const
+  {
+    return _scripts.size();
+  }
+
+  util::PoolAllocator& allocator()
+  {
+    return _allocator;
+  }
+
+  static Scheduler* current();
+
+ private:
+  struct Wakeup
+  {
+    double time;
+    uint64_t sequence;
+    std::coroutine_handle<> handle;
+
+    bool operator>(const Wakeup& other) const
+    {
+      return time > other.time ||
+             (time == other.time && sequence > other.sequence);
+    }
+  };
+
+  static Scheduler* setCurrent(Scheduler* scheduler);
+
+  void finish(Script::Handle handle);
+
+ private:
+  util::PoolAllocator _allocator;
+
+  Timeline& _timeline;
+  double _time = 0.0;
+
+  std::vector<Script::Handle> _scripts;
+  std::vector<Script::Handle> _finished;
+
+  std::priority_queue<Wakeup, std::vector<Wakeup>, std::greater<Wakeup>>
+    _wakeups;
+  uint64_t _sequence = 0;
+
+  friend struct Script::FinalAwaiter;
+};
+
+struct WaitAwaiter
+{
+  Seconds duration;
+
+  bool await_ready() const noexcept
+  {
+    return duration.count() <= 0.0;
+  }
+
+  void await_suspend(std::coroutine_handle<> handle) const;
+
+  void await_resume() const noexcept
+  {
+  }
+};
+
+struct PlayAwaiter
+{
+  Tween tween;
+  Seconds duration;
+
+  bool await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void await_suspend(std::coroutine_handle<> handle) const;
+
+  void await_resume() const noexcept
+  {
+  }
+};
+
+WaitAwaiter wait(Seconds duration);
+PlayAwaiter play(const Tween& tween, Seconds duration);
+}  // namespace animation
@@ -0,0 +1,463 @@
+#include "timeline.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace animation
+{
+size_t Timeline::addTrack(util::Transform& transform, TrackProperty property)
+{
+  return addTrack(&transform, property);
+}
+
+size_t Timeline::addTrack(graphics::Text& text, TrackProperty property)
+{
+  return addTrack(&text, property);
+}
+
+size_t Timeline::addTrack(graphics::Camera& camera, TrackProperty property)
+{
+  return addTrack(&camera, property);
+}
+
+size_t Timeline::addTrack(
+  graphics::NumberText& number,
+  TrackProperty property
+)
+{
+  return addTrack(&number, property);
+}
+
+size_t Timeline::addTrack(void* target, TrackProperty property)
+{
+  _trackTargets.push_back(target);
+  _trackProperties.push_back(property);
+  _trackIndices.try_emplace({target, property}, _trackTargets.size() - 1);
+  _dirty = true;
+  return _trackTargets.size() - 1;
+}
+
+size_t Timeline::track(util::Transform& transform, TrackProperty property)
+{
+  return track(&transform, property);
+}
+
+size_t Timeline::track(graphics::Text& text, TrackProperty property)
+{
+  return track(&text, property);
+}
+
+size_t Timeline::track(graphics::Camera& camera, TrackProperty property)
+{
+  return track(&camera, property);
+}
+
+size_t Timeline::track(graphics::NumberText& number, TrackProperty property)
+{
+  return track(&number, property);
+}
+
+size_t Timeline::track(void* target, TrackProperty property)
+{
+  auto it = _trackIndices.find({target, property});
+  if (it != _trackIndices.end())
+  {
+    return it->second;
+  }
+  return addTrack(target, property);
+}
+
+void Timeline::addKey(
+  size_t track,
+  float time,
+  const glm::vec4& value,
+  Easing easing
+)
+{
+  _keys.push_back({(uint32_t)track, time, value, easing});
+  _duration = std::max(_duration, time);
+  _dirty = true;
+}
+
+void Timeline::addKey(
+  size_t track,
+  float time,
+  const glm::vec3& value,
+  Easing easing
+)
+{
+  addKey(track, time, glm::vec4(value, 0.0f), easing);
+}
+
+void Timeline::addKey(
+  size_t track,
+  float time,
+  const glm::quat& value,
+  Easing easing
+)
+{
+  addKey(track, time, glm::vec4(value.x, value.y, value.z, value.w), easing);
+}
+
+void Timeline::addKey(size_t track, float time, float value, Easing easing)
+{
+  addKey(track, time, glm::vec4(value, 0.0f, 0.0f, 0.0f), easing);
+}
+
+void Timeline::evaluate(double time)
+{
+  if (_dirty)
+  {
+    build();
+  }
+
+  if (_keyTimes.empty())
+  {
+    return;
+  }
+
+  if (!std::isnan(_evaluatedTime) && !changes(_evaluatedTime, time))
+  {
+    return;
+  }
+  _evaluatedTime = time;
+
+  locate((float)time);
+  ease();
+  interpolate();
+  apply();
+}
+
+bool Timeline::changes(double from, double to)
+{
+  if (_dirty)
+  {
+    build();
+  }
+
+  if (from == to)
+  {
+    return false;
+  }
+
+  // values are continuous, so they only differ if an active interval
+  // overlaps the open range between both times
+  float begin = (float)std::min(from, to);
+  float end = (float)std::max(from, to);
+  auto it = std::upper_bound(
+    _activeIntervals.begin(),
+    _activeIntervals.end(),
+    begin,
+    [](float time, const glm::vec2& interval) { return time < interval.y; }
+  );
+  return it != _activeIntervals.end() && it->x < end;
+}
+
+double Timeline::nextChange(double time)
+{
+  if (_dirty)
+  {
+    build();
+  }
+
+  auto it = std::upper_bound(
+    _activeIntervals.begin(),
+    _activeIntervals.end(),
+    (float)time,
+    [](float time, const glm::vec2& interval) { return time < interval.y; }
+  );
+  if (it == _activeIntervals.end())
+  {
+    return std::numeric_limits<double>::infinity();
+  }
+  return std::max((double)it->x, time);
+}
+
+glm::vec4 Timeline::valueAt(size_t track, double time)
+{
+  if (_dirty)
+  {
+    build();
+  }
+
+  uint32_t first = _trackFirstKeys[track];
+  uint32_t count = _trackKeyCounts[track];
+  if (count == 0)
+  {
+    return read(track);
+  }
+
+  uint32_t last = first + count - 1;
+  if (time <= _keyTimes[first])
+  {
+    return _keyValues[first];
+  }
+  if (time >= _keyTimes[last])
+  {
+    return _keyValues[last];
+  }
+
+  uint32_t from = first + search((uint32_t)track, (float)time);
+  float factor = ((float)time - _keyTimes[from]) /
+                 (_keyTimes[from + 1] - _keyTimes[from]);
+  factor = animation::ease(_keyEasings[from], factor);
+  return _keyValues[from] + (_keyValues[from + 1] - _keyValues[from]) * factor;
+}
+
+glm::vec4 Timeline::read(size_t track) const
+{
+  void* target = _trackTargets[track];
+  switch (_trackProperties[track])
+  {
+    case TrackProperty::Position:
+      return glm::vec4(((util::Transform*)target)->position(), 0.0f);
+
+    case TrackProperty::Rotation:
+    {
+      const auto& rotation = ((util::Transform*)target)->rotation();
+      return glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+    }
+
+    case TrackProperty::Scale:
+      return glm::vec4(((util::Transform*)target)->scale(), 0.0f);
+
+    case TrackProperty::Color:
+      return glm::vec4(((graphics::Text*)target)->color(), 0.0f);
+
+    case TrackProperty::Opacity:
+      return glm::vec4(((graphics::Text*)target)->opacity(), 0.0f, 0.0f, 0.0f);
+
+    case TrackProperty::CameraPosition:
+      return glm::vec4(((graphics::Camera*)target)->position(), 0.0f);
+
+    case TrackProperty::CameraRotation:
+    {
+      const auto& rotation = ((graphics::Camera*)target)->rotation();
+      return glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+    }
+
+    case TrackProperty::CameraFov:
+      return glm::vec4(((graphics::Camera*)target)->fov(), 0.0f, 0.0f, 0.0f);
+
+    case TrackProperty::Value:
+    {
+      auto value = (float)((graphics::NumberText*)target)->value();
+      return glm::vec4(value, 0.0f, 0.0f, 0.0f);
+    }
+  }
+  return glm::vec4(0.0f);
+}
+
+void Timeline::build()
+{
+  _dirty = false;
+
+  std::stable_sort(
+    _keys.begin(),
+    _keys.end(),
+    [](const Key& a, const Key& b)
+    { return a.track < b.track || (a.track == b.track && a.time < b.time); }
+  );
+
+  size_t trackCount = _trackTargets.size();
+  _trackFirstKeys.assign(trackCount, 0);
+  _trackKeyCounts.assign(trackCount, 0);
+  _trackCursors.assign(trackCount, 0);
+
+  _keyTimes.resize(_keys.size());
+  _keyValues.resize(_keys.size());
+  _keyEasings.resize(_keys.size());
+
+  for (size_t i = 0; i < _keys.size(); i++)
+  {
+    const auto& key = _keys[i];
+    if (_trackKeyCounts[key.track]++ == 0)
+    {
+      _trackFirstKeys[key.track] = (uint32_t)i;
+    }
+
+    _keyTimes[i] = key.time;
+    _keyValues[i] = key.value;
+    _keyEasings[i] = key.easing;
+
+    // keep consecutive rotations in the same hemisphere, so a normalized
+    // linear blend takes the shortest path
+    auto property = _trackProperties[key.track];
+    bool rotation = property == TrackProperty::Rotation ||
+                    property == TrackProperty::CameraRotation;
+    if (rotation && _trackKeyCounts[key.track] > 1 &&
+        glm::dot(_keyValues[i - 1], _keyValues[i]) < 0.0f)
+    {
+      _keyValues[i] = -_keyValues[i];
+    }
+  }
+
+  _fromKeys.resize(trackCount);
+  _toKeys.resize(trackCount);
+  _factors.resize(trackCount);
+  _results.resize(trackCount);
+
+  _activeIntervals.clear();
+  for (size_t i = 0; i + 1 < _keys.size(); i++)
+  {
+    if (_keys[i].track == _keys[i + 1].track &&
+        _keyValues[i] != _keyValues[i + 1])
+    {
+      _activeIntervals.emplace_back(_keyTimes[i], _keyTimes[i + 1]);
+    }
+  }
+
+  std::sort(
+    _activeIntervals.begin(),
+    _activeIntervals.end(),
+    [](const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; }
+  );
+
+  size_t merged = 0;
+  for (size_t i = 0; i < _activeIntervals.size(); i++)
+  {
+    if (merged > 0 && _activeIntervals[i].x <= _activeIntervals[merged - 1].y)
+    {
+      _activeIntervals[merged - 1].y =
+        std::max(_activeIntervals[merged - 1].y, _activeIntervals[i].y);
+    }
+    else
+    {
+      _activeIntervals[merged++] = _activeIntervals[i];
+    }
+  }
+  _activeIntervals.resize(merged);
+
+  _evaluatedTime = std::numeric_limits<double>::quiet_NaN();
+}
+
+void Timeline::locate(float time)
+{
+  for (size_t i = 0; i < _trackTargets.size(); i++)
+  {
+    uint32_t first = _trackFirstKeys[i];
+    uint32_t count = _trackKeyCounts[i];
+    uint32_t last = first + std::max(count, 1u) - 1;
+
+    if (count < 2 || time <= _keyTimes[first] || time >= _keyTimes[last])
+    {
+      uint32_t key = time >= _keyTimes[last] ? last : first;
+      _fromKeys[i] = key;
+      _toKeys[i] = key;
+      _factors[i] = 0.0f;
+      continue;
+    }
+
+    // playback usually stays in the cached segment or moves to the next one
+    uint32_t cursor = _trackCursors[i];
+    uint32_t from = first + cursor;
+    if (time < _keyTimes[from] || time >= _keyTimes[from + 1])
+    {
+      if (cursor + 2 < count && time >= _keyTimes[from + 1] &&
+          time < _keyTimes[from + 2])
+      {
+        cursor++;
+      }
+      else
+      {
+        cursor = search((uint32_t)i, time);
+      }
+      _trackCursors[i] = cursor;
+      from = first + cursor;
+    }
+
+    _fromKeys[i] = from;
+    _toKeys[i] = from + 1;
+    _factors[i] =
+      (time - _keyTimes[from]) / (_keyTimes[from + 1] - _keyTimes[from]);
+  }
+}
+
+void Timeline::ease()
+{
+  for (size_t i = 0; i < _factors.size(); i++)
+  {
+    _factors[i] = animation::ease(_keyEasings[_fromKeys[i]], _factors[i]);
+  }
+}
+
+void Timeline::interpolate()
+{
+  const auto* values = _keyValues.data();
+  const auto* fromKeys = _fromKeys.data();
+  const auto* toKeys = _toKeys.data();
+  const auto* factors = _factors.data();
+  auto* results = _results.data();
+
+  for (size_t i = 0; i < _results.size(); i++)
+  {
+    const auto& from = values[fromKeys[i]];
+    const auto& to = values[toKeys[i]];
+    results[i] = from + (to - from) * factors[i];
+  }
+}
+
+void Timeline::apply()
+{
+  for (size_t i = 0; i < _trackTargets.size(); i++)
+  {
+    if (_trackKeyCounts[i] == 0)
+    {
+      continue;
+    }
+
+    const auto& result = _results[i];
+    glm::vec3 vector(result.x, result.y, result.z);
+    glm::quat rotation =
+      glm::normalize(glm::quat(result.w, result.x, result.y, result.z));
+
+    switch (_trackProperties[i])
+    {
+      case TrackProperty::Position:
+        ((util::Transform*)_trackTargets[i])->setPosition(vector);
+        break;
+
+      case TrackProperty::Rotation:
+        ((util::Transform*)_trackTargets[i])->setRotation(rotation);
+        break;
+
+      case TrackProperty::Scale:
+        ((util::Transform*)_trackTargets[i])->setScale(vector);
+        break;
+
+      case TrackProperty::Color:
+        ((graphics::Text*)_trackTargets[i])->setColor(vector);
+        break;
+
+      case TrackProperty::Opacity:
+        ((graphics::Text*)_trackTargets[i])->setOpacity(result.x);
+        break;
+
+      case TrackProperty::CameraPosition:
+        ((graphics::Camera*)_trackTargets[i])->setPosition(vector);
+        break;
+
+      case TrackProperty::CameraRotation:
+        ((graphics::Camera*)_trackTargets[i])->setRotation(rotation);
+        break;
+
+      case TrackProperty::CameraFov:
+        ((graphics::Camera*)_trackTargets[i])->setFov(result.x);
+        break;
+
+      case TrackProperty::Value:
+        ((graphics::NumberText*)_trackTargets[i])->setValue(result.x);
+        break;
+    }
+  }
+}
+
+uint32_t Timeline::search(uint32_t track, float time) const
+{
+  auto begin = _keyTimes.begin() + _trackFirstKeys[track];
+  auto end = begin + _trackKeyCounts[track];
+
+  auto it = std::upper_bound(begin, end, time);
+  return (uint32_t)std::max<ptrdiff_t>(it - begin - 1, 0);
+}
+}  // namespace animation
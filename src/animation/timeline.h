@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "animation/easing.h"
+#include "graphics/camera.h"
+#include "graphics/number_text.h"
+#include "graphics/text.h"
+#include "util/transform.h"
+
+namespace animation
+{
+enum class TrackProperty : uint8_t
+{
+  Position,
+  Rotation,
+  Scale,
+  Color,
+  Opacity,
+  CameraPosition,
+  CameraRotation,
+  CameraFov,
+  Value,
+};
+
+// Keyframe animation of transform, text and camera properties.
+//
+// Keys of all tracks are stored as structure of arrays, every track owns a
+// contiguous range. Evaluation runs in separate passes over all tracks
+// (locate the segment, ease, interpolate, apply), so the interpolation pass
+// is a tight loop over plain arrays. Each track caches the segment it was
+// evaluated at last, playback advances in O(1) and scrubbing to an
+// arbitrary time falls back to a binary search.
+//
+// Segments between two different keys are merged into a list of active
+// intervals. Evaluating a time within the same hold as the previous
+// evaluation is skipped, so targets are not touched during still frames.
+class Timeline
+{
+ public:
+  Timeline() = default;
+  ~Timeline() = default;
+
+  size_t addTrack(util::Transform& transform, TrackProperty property);
+  size_t addTrack(graphics::Text& text, TrackProperty property);
+  size_t addTrack(graphics::Camera& camera, TrackProperty property);
+  size_t addTrack(graphics::NumberText& number, TrackProperty property);
+
+  // returns the existing track of the property, or adds a new one
+  size_t track(util::Transform& transform, TrackProperty property);
+  size_t track(graphics::Text& text, TrackProperty property);
+  size_t track(graphics::Camera& camera, TrackProperty property);
+  size_t track(graphics::NumberText& number, TrackProperty property);
+
+  void addKey(
+    size_t track,
+    float time,
+    const glm::vec4& value,
+    Easing easing = Easing::Linear
+  );
+  void addKey(
+    size_t track,
+    float time,
+    const glm::vec3& value,
+    Easing easing = Easing::Linear
+  );
+  void addKey(
+    size_t track,
+    float time,
+    const glm::quat& value,
+    Easing easing = Easing::Linear
+  );
+  void addKey(
+    size_t track,
+    float time,
+    float value,
+    Easing easing = Easing::Linear
+  );
+
+  void evaluate(double time);
+
+  // false if no track changes its value between the two times, i.e. both
+  // lie in the same hold
+  bool changes(double from, double to);
+
+  // start of the next change after the time, infinity if every track holds
+  // its last key
+  double nextChange(double time);
+
+  // value of a single track, the current value of the target if the track
+  // has no keys yet
+  glm::vec4 valueAt(size_t track, double time);
+
+  size_t trackCount() const
+  {
+    return _trackProperties.size();
+  }
+
+  float duration() const
+  {
+    return _duration;
+  }
+
+ private:
+  struct Key
+  {
+    uint32_t track;
+    float time;
+    glm::vec4 value;
+    Easing easing;
+  };
+
+  size_t addTrack(void* target, TrackProperty property);
+  size_t track(void* target, TrackProperty property);
+
+  glm::vec4 read(size_t track) const;
+
+  void build();
+
+  void locate(float time);
+  void ease();
+  void interpolate();
+  void apply();
+
+  uint32_t search(uint32_t track, float time) const;
+
+ private:
+  // tracks
+  std::vector<void*> _trackTargets;
+  std::vector<TrackProperty> _trackProperties;
+  std::vector<uint32_t> _trackFirstKeys;
+  std::vector<uint32_t> _trackKeyCounts;
+  std::vector<uint32_t> _trackCursors;
+  std::map<std::pair<void*, TrackProperty>, size_t> _trackIndices;
+
+  // keys
+  std::vector<float> _keyTimes;
+  std::vector<glm::vec4> _keyValues;
+  std::vector<Easing> _keyEasings;
+
+  // per evaluation
+  std::vector<uint32_t> _fromKeys;
+  std::vector<uint32_t> _toKeys;
+  std::vector<float> _factors;
+  std::vector<glm::vec4> _results;
+
+  // merged [start, end] intervals in which at least one track changes
+  std::vector<glm::vec2> _activeIntervals;
+  double _evaluatedTime = std::numeric_limits<double>::quiet_NaN();
+
+  // authored keys, sorted into the arrays above on the next evaluation
+  std::vector<Key> _keys;
+  bool _dirty = false;
+
+  float _duration = 0.0f;
+};
+}  // namespace animation
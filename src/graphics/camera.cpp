@@ -73,11 +73,13 @@ void Camera::recalculateView()
   _view =
     glm::translate(glm::mat4(1.0f), _position) * glm::mat4_cast(_rotation);
   _viewProjection = _projection * glm::inverse(_view);
+  _revision++;
 }
 
 void Camera::recalculateProjection()
 {
   _projection = glm::perspective(_fov, _aspect, _near, _far);
   _viewProjection = _projection * glm::inverse(_view);
+  _revision++;
 }
 }  // namespace graphics
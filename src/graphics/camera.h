@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -63,6 +64,12 @@ class Camera
     return _viewProjection;
   }
 
+  // incremented whenever the view projection changes
+  uint64_t revision() const
+  {
+    return _revision;
+  }
+
  private:
   void recalculateView();
   void recalculateProjection();
@@ -79,5 +86,7 @@ class Camera
   glm::mat4 _view{1.0f};
   glm::mat4 _projection{1.0f};
   glm::mat4 _viewProjection{1.0f};
+
+  uint64_t _revision = 0;
 };
 }  // namespace graphics
@@ -6,14 +6,14 @@
 #include <iostream>
 #include <vector>
 
+#include "util/profiler.h"
+
 namespace graphics
 {
-Font::Font(
-  const wgpu::Device& device,
-  const wgpu::Queue& queue,
-  const std::filesystem::path& directory
-)
+FontData Font::decode(const std::filesystem::path& directory)
 {
+  TANIM_PROFILE_ZONE("Font::decode");
+
   auto jsonPath = directory / directory.filename().concat(".json");
 
   std::ifstream file(jsonPath);
@@ -23,7 +23,10 @@ Font::Font(
   }
   auto json = nlohmann::json::parse(file);
 
-  _lineHeight = json["common"]["lineHeight"];
+  FontData data;
+  data.lineHeight = json["common"]["lineHeight"];
+  data.size = json["info"]["size"];
+  data.base = json["common"]["base"];
 
   float u = 1.0f / (float)json["common"]["scaleW"];
   float v = 1.0f / (float)json["common"]["scaleH"];
@@ -43,12 +46,12 @@ Font::Font(
       .page = c["page"],
       .advance = c["xadvance"],
     };
-    _characters.insert({c["id"], character});
+    data.characters.insert({c["id"], character});
   }
 
   for (const auto& k : json["kernings"])
   {
-    _kernings.insert({kerningKey(k["first"], k["second"]), k["amount"]});
+    data.kernings.insert({kerningKey(k["first"], k["second"]), k["amount"]});
   }
 
   auto atlasPath = directory / json["pages"][0];
@@ -67,10 +70,39 @@ Font::Font(
     throw std::runtime_error("Failed to load image: " + atlasPath.string());
   }
 
+  data.width = (uint32_t)width;
+  data.height = (uint32_t)height;
+  data.pixels.assign(pixels, pixels + 4 * sizeof(uint8_t) * width * height);
+  stbi_image_free(pixels);
+
+  return data;
+}
+
+Font::Font(
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  const std::filesystem::path& directory
+)
+  : Font(device, queue, decode(directory))
+{
+}
+
+Font::Font(const wgpu::Device& device, const wgpu::Queue& queue, FontData data)
+  : _characters(std::move(data.characters)),
+    _kernings(std::move(data.kernings)),
+    _lineHeight(data.lineHeight),
+    _size(data.size),
+    _base(data.base)
+{
+  TANIM_PROFILE_ZONE("Font::Font");
+
+  uint32_t width = data.width;
+  uint32_t height = data.height;
+
   wgpu::TextureDescriptor textureDescriptor{};
   textureDescriptor.dimension = wgpu::TextureDimension::e2D;
   textureDescriptor.label = "Font Atlas";
-  textureDescriptor.size = {(uint32_t)width, (uint32_t)height, 1};
+  textureDescriptor.size = {width, height, 1};
   textureDescriptor.mipLevelCount = 1;
   textureDescriptor.sampleCount = 1;
   textureDescriptor.format = wgpu::TextureFormat::RGBA8Unorm;
@@ -91,14 +123,12 @@ Font::Font(
 
   queue.WriteTexture(
     &destination,
-    pixels,
-    4 * sizeof(uint8_t) * width * height,
+    data.pixels.data(),
+    data.pixels.size(),
     &source,
     &textureDescriptor.size
   );
 
-  stbi_image_free(pixels);
-
   wgpu::TextureViewDescriptor viewDescriptor{};
   viewDescriptor.label = "Font Atlas View";
   viewDescriptor.format = wgpu::TextureFormat::RGBA8Unorm;
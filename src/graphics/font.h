@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 #include <nlohmann/json.hpp>
 #include <unordered_map>
+#include <vector>
 
 namespace graphics
 {
@@ -26,6 +27,23 @@ struct FontCharacter
   int advance;
 };
 
+// Metrics and decoded atlas of a font, read without touching the GPU so it
+// can be prepared on another thread.
+struct FontData
+{
+  std::unordered_map<uint32_t, FontCharacter> characters;
+  std::unordered_map<uint64_t, float> kernings;
+
+  float lineHeight = 0.0f;
+  float size = 0.0f;
+  float base = 0.0f;
+
+  // RGBA8 atlas
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> pixels;
+};
+
 class Font
 {
  public:
@@ -34,8 +52,12 @@ class Font
     const wgpu::Queue& queue,
     const std::filesystem::path& directory
   );
+  Font(const wgpu::Device& device, const wgpu::Queue& queue, FontData data);
   ~Font() = default;
 
+  // reads the msdf json and atlas of a font directory, thread safe
+  static FontData decode(const std::filesystem::path& directory);
+
   const FontCharacter& operator[](uint32_t unicode) const
   {
     return _characters.at(unicode);
@@ -71,8 +93,20 @@ class Font
     return _lineHeight;
   }
 
+  // size of the em square the atlas was generated at
+  float size() const
+  {
+    return _size;
+  }
+
+  // distance from the top of a line to the baseline
+  float base() const
+  {
+    return _base;
+  }
+
  private:
-  uint64_t kerningKey(uint32_t firstUnicode, uint32_t secondUnicode) const
+  static uint64_t kerningKey(uint32_t firstUnicode, uint32_t secondUnicode)
   {
     return (uint64_t)firstUnicode << 32 | secondUnicode;
   }
@@ -84,5 +118,7 @@ class Font
   wgpu::TextureView _atlasView;
 
   float _lineHeight = 0.0f;
+  float _size = 0.0f;
+  float _base = 0.0f;
 };
 }  // namespace graphics
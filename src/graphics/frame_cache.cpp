@@ -0,0 +1,270 @@
+#include "frame_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+namespace graphics
+{
+FrameCache::FrameCache(
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  wgpu::TextureFormat format,
+  uint32_t width,
+  uint32_t height,
+  float scale,
+  size_t budget
+)
+  : _format(format),
+    _width(std::max((uint32_t)((float)width * scale), 1u)),
+    _height(std::max((uint32_t)((float)height * scale), 1u)),
+    _entryBytes((size_t)_width * _height * 4),
+    _capacity(budget / _entryBytes),
+    _device(device),
+    _queue(queue)
+{
+  createPipeline();
+}
+
+void FrameCache::store(uint64_t frame, const wgpu::TextureView& source)
+{
+  if (_capacity == 0)
+  {
+    return;
+  }
+
+  auto it = _entries.find(frame);
+  if (it != _entries.end())
+  {
+    _recent.splice(_recent.begin(), _recent, it->second.recent);
+  }
+  else if (_freeTextures.empty() && _textures.size() >= _capacity)
+  {
+    // the least recently used frame hands over its texture along with its
+    // list and map nodes, so a full cache stores frames without allocating
+    auto node = _entries.extract(_recent.back());
+    _recent.splice(_recent.begin(), _recent, std::prev(_recent.end()));
+    _recent.front() = frame;
+    node.key() = frame;
+    node.mapped().recent = _recent.begin();
+    it = _entries.insert(std::move(node)).position;
+  }
+  else
+  {
+    _recent.push_front(frame);
+    it = _entries.emplace(frame, Entry{acquireTexture(), _recent.begin()})
+           .first;
+  }
+
+  blit(source, _textures[it->second.texture].view);
+}
+
+bool FrameCache::present(uint64_t frame, const wgpu::TextureView& target)
+{
+  auto it = _entries.find(frame);
+  if (it == _entries.end())
+  {
+    return false;
+  }
+
+  _recent.splice(_recent.begin(), _recent, it->second.recent);
+
+  draw(_textures[it->second.texture].bindGroup, target);
+  return true;
+}
+
+void FrameCache::blit(
+  const wgpu::TextureView& source,
+  const wgpu::TextureView& target
+)
+{
+  // cached textures bring their own bind group, so the one of the render
+  // target survives presenting cached frames in between
+  if (_source.Get() != source.Get())
+  {
+    _source = source;
+    _sourceBindGroup = createBindGroup(source);
+  }
+
+  draw(_sourceBindGroup, target);
+}
+
+void FrameCache::draw(
+  const wgpu::BindGroup& bindGroup,
+  const wgpu::TextureView& target
+)
+{
+  wgpu::CommandEncoderDescriptor encoderDescriptor{};
+  encoderDescriptor.label = "Frame Cache Command Encoder";
+  auto encoder = _device.CreateCommandEncoder(&encoderDescriptor);
+
+  wgpu::RenderPassColorAttachment colorAttachment{};
+  colorAttachment.view = target;
+  colorAttachment.loadOp = wgpu::LoadOp::Clear;
+  colorAttachment.storeOp = wgpu::StoreOp::Store;
+  colorAttachment.clearValue = {0.0, 0.0, 0.0, 1.0};
+  colorAttachment.depthSlice = wgpu::kDepthSliceUndefined;
+
+  wgpu::RenderPassDescriptor renderPassDescriptor{};
+  renderPassDescriptor.label = "Frame Cache Render Pass";
+  renderPassDescriptor.colorAttachmentCount = 1;
+  renderPassDescriptor.colorAttachments = &colorAttachment;
+
+  auto renderPass = encoder.BeginRenderPass(&renderPassDescriptor);
+  renderPass.SetPipeline(_pipeline);
+  renderPass.SetBindGroup(0, bindGroup);
+  renderPass.Draw(3, 1, 0, 0);
+  renderPass.End();
+
+  wgpu::CommandBufferDescriptor commandDescriptor{};
+  commandDescriptor.label = "Frame Cache Command Buffer";
+  auto command = encoder.Finish(&commandDescriptor);
+
+  _queue.Submit(1, &command);
+}
+
+void FrameCache::clear()
+{
+  for (const auto& [frame, entry] : _entries)
+  {
+    _freeTextures.push_back(entry.texture);
+  }
+  _entries.clear();
+  _recent.clear();
+}
+
+size_t FrameCache::acquireTexture()
+{
+  if (!_freeTextures.empty())
+  {
+    size_t texture = _freeTextures.back();
+    _freeTextures.pop_back();
+    return texture;
+  }
+
+  wgpu::TextureDescriptor textureDescriptor{};
+  textureDescriptor.label = "Frame Cache Texture";
+  textureDescriptor.dimension = wgpu::TextureDimension::e2D;
+  textureDescriptor.size = {_width, _height, 1};
+  textureDescriptor.mipLevelCount = 1;
+  textureDescriptor.sampleCount = 1;
+  textureDescriptor.format = _format;
+  textureDescriptor.usage =
+    wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding;
+
+  auto& cached = _textures.emplace_back();
+  cached.texture = _device.CreateTexture(&textureDescriptor);
+  cached.view = cached.texture.CreateView();
+  cached.bindGroup = createBindGroup(cached.view);
+  return _textures.size() - 1;
+}
+
+void FrameCache::createPipeline()
+{
+  wgpu::SamplerDescriptor samplerDescriptor{};
+  samplerDescriptor.label = "Frame Cache Sampler";
+  samplerDescriptor.minFilter = wgpu::FilterMode::Linear;
+  samplerDescriptor.magFilter = wgpu::FilterMode::Linear;
+  samplerDescriptor.addressModeU = wgpu::AddressMode::ClampToEdge;
+  samplerDescriptor.addressModeV = wgpu::AddressMode::ClampToEdge;
+  samplerDescriptor.addressModeW = wgpu::AddressMode::ClampToEdge;
+  _sampler = _device.CreateSampler(&samplerDescriptor);
+
+  std::array<wgpu::BindGroupLayoutEntry, 2> bindGroupLayoutEntries{};
+  bindGroupLayoutEntries[0].binding = 0;
+  bindGroupLayoutEntries[0].visibility = wgpu::ShaderStage::Fragment;
+  bindGroupLayoutEntries[0].texture.sampleType = wgpu::TextureSampleType::Float;
+  bindGroupLayoutEntries[0].texture.viewDimension =
+    wgpu::TextureViewDimension::e2D;
+
+  bindGroupLayoutEntries[1].binding = 1;
+  bindGroupLayoutEntries[1].visibility = wgpu::ShaderStage::Fragment;
+  bindGroupLayoutEntries[1].sampler.type = wgpu::SamplerBindingType::Filtering;
+
+  wgpu::BindGroupLayoutDescriptor bindGroupLayoutDescriptor{};
+  bindGroupLayoutDescriptor.label = "Frame Cache Bind Group Layout";
+  bindGroupLayoutDescriptor.entryCount =
+    (uint32_t)bindGroupLayoutEntries.size();
+  bindGroupLayoutDescriptor.entries = bindGroupLayoutEntries.data();
+  _bindGroupLayout = _device.CreateBindGroupLayout(&bindGroupLayoutDescriptor);
+
+  const char* shaderCode = R"(
+    struct VertexOutput {
+      @builtin(position) position: vec4f,
+      @location(0) uv: vec2f,
+    };
+
+    @group(0) @binding(0) var source: texture_2d<f32>;
+    @group(0) @binding(1) var sourceSampler: sampler;
+
+    // a single triangle covering the whole target
+    @vertex
+    fn vsMain(@builtin(vertex_index) vertexIndex: u32) -> VertexOutput {
+      let uv = vec2f(f32((vertexIndex << 1u) & 2u), f32(vertexIndex & 2u));
+
+      var out: VertexOutput;
+      out.position = vec4f(uv * vec2f(2.0, -2.0) + vec2f(-1.0, 1.0), 0.0, 1.0);
+      out.uv = uv;
+      return out;
+    }
+
+    @fragment
+    fn fsMain(in: VertexOutput) -> @location(0) vec4f {
+      return textureSample(source, sourceSampler, in.uv);
+    }
+)";
+
+  wgpu::ShaderModuleWGSLDescriptor wgslDescriptor{};
+  wgslDescriptor.code = shaderCode;
+  wgslDescriptor.sType = wgpu::SType::ShaderSourceWGSL;
+
+  wgpu::ShaderModuleDescriptor shaderModuleDescriptor{};
+  shaderModuleDescriptor.label = "Frame Cache Shader Module";
+  shaderModuleDescriptor.nextInChain = &wgslDescriptor;
+
+  wgpu::ShaderModule shaderModule =
+    _device.CreateShaderModule(&shaderModuleDescriptor);
+
+  wgpu::ColorTargetState colorTargetState{};
+  colorTargetState.format = _format;
+  colorTargetState.writeMask = wgpu::ColorWriteMask::All;
+
+  wgpu::FragmentState fragmentState{};
+  fragmentState.module = shaderModule;
+  fragmentState.targetCount = 1;
+  fragmentState.targets = &colorTargetState;
+
+  wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{};
+  pipelineLayoutDescriptor.label = "Frame Cache Pipeline Layout";
+  pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
+  pipelineLayoutDescriptor.bindGroupLayouts = &_bindGroupLayout;
+  auto pipelineLayout = _device.CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+  wgpu::RenderPipelineDescriptor pipelineDescriptor{};
+  pipelineDescriptor.label = "Frame Cache Pipeline";
+  pipelineDescriptor.fragment = &fragmentState;
+  pipelineDescriptor.vertex.module = shaderModule;
+  pipelineDescriptor.primitive.topology = wgpu::PrimitiveTopology::TriangleList;
+  pipelineDescriptor.layout = pipelineLayout;
+  _pipeline = _device.CreateRenderPipeline(&pipelineDescriptor);
+}
+
+wgpu::BindGroup FrameCache::createBindGroup(
+  const wgpu::TextureView& source
+) const
+{
+  std::array<wgpu::BindGroupEntry, 2> bindGroupEntries{};
+  bindGroupEntries[0].textureView = source;
+  bindGroupEntries[0].binding = 0;
+
+  bindGroupEntries[1].sampler = _sampler;
+  bindGroupEntries[1].binding = 1;
+
+  wgpu::BindGroupDescriptor bindGroupDescriptor{};
+  bindGroupDescriptor.label = "Frame Cache Bind Group";
+  bindGroupDescriptor.entryCount = bindGroupEntries.size();
+  bindGroupDescriptor.entries = bindGroupEntries.data();
+  bindGroupDescriptor.layout = _bindGroupLayout;
+  return _device.CreateBindGroup(&bindGroupDescriptor);
+}
+}  // namespace graphics
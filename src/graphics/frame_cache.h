@@ -0,0 +1,112 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace graphics
+{
+// Keeps rendered preview frames on the GPU, optionally at a reduced
+// resolution. Showing a cached frame is a single blit instead of evaluating
+// and rendering the scene again, which makes scrubbing over frames that were
+// seen before instant.
+//
+// The number of frames is bounded by a memory budget, the least recently
+// used frame is evicted and its texture reused for the new one.
+class FrameCache
+{
+ public:
+  FrameCache(
+    const wgpu::Device& device,
+    const wgpu::Queue& queue,
+    wgpu::TextureFormat format,
+    uint32_t width,
+    uint32_t height,
+    float scale,
+    size_t budget
+  );
+  ~FrameCache() = default;
+
+  FrameCache(const FrameCache&) = delete;
+  FrameCache& operator=(const FrameCache&) = delete;
+
+  bool contains(uint64_t frame) const
+  {
+    return _entries.find(frame) != _entries.end();
+  }
+
+  // copies a rendered frame into the cache
+  void store(uint64_t frame, const wgpu::TextureView& source);
+
+  // blits a cached frame into the target, returns false on a miss
+  bool present(uint64_t frame, const wgpu::TextureView& target);
+
+  // scales the source into the target, both have to use the cache format
+  void blit(const wgpu::TextureView& source, const wgpu::TextureView& target);
+
+  void clear();
+
+  size_t size() const
+  {
+    return _entries.size();
+  }
+
+  size_t capacity() const
+  {
+    return _capacity;
+  }
+
+  size_t memoryUsage() const
+  {
+    return _textures.size() * _entryBytes;
+  }
+
+ private:
+  struct Entry
+  {
+    size_t texture;
+    std::list<uint64_t>::iterator recent;
+  };
+
+  struct CachedTexture
+  {
+    wgpu::Texture texture;
+    wgpu::TextureView view;
+    wgpu::BindGroup bindGroup;
+  };
+
+  void createPipeline();
+  wgpu::BindGroup createBindGroup(const wgpu::TextureView& source) const;
+
+  void draw(const wgpu::BindGroup& bindGroup, const wgpu::TextureView& target);
+
+  // a free texture or a new one, store evicts once the budget is used up
+  size_t acquireTexture();
+
+ private:
+  wgpu::TextureFormat _format;
+  uint32_t _width;
+  uint32_t _height;
+  size_t _entryBytes;
+  size_t _capacity;
+
+  std::unordered_map<uint64_t, Entry> _entries;
+  // most recently used frame first
+  std::list<uint64_t> _recent;
+  std::vector<CachedTexture> _textures;
+  std::vector<size_t> _freeTextures;
+
+  wgpu::Sampler _sampler;
+  wgpu::BindGroupLayout _bindGroupLayout;
+  wgpu::RenderPipeline _pipeline;
+
+  wgpu::TextureView _source;
+  wgpu::BindGroup _sourceBindGroup;
+
+  const wgpu::Device& _device;
+  const wgpu::Queue& _queue;
+};
+}  // namespace graphics
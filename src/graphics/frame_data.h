@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "graphics/camera.h"
+#include "graphics/gpu_types.h"
+#include "graphics/number_text.h"
+#include "graphics/text.h"
+
+namespace graphics
+{
+class TextMorph;
+class TextStroke;
+
+// Everything the renderer needs to draw one frame. Evaluating a frame only
+// writes into this struct, so frames can be evaluated on any thread and
+// submitted later.
+struct FrameData
+{
+  uint64_t frame = 0;
+  double time = 0.0;
+
+  // the frame looks exactly like the previous one and was not evaluated,
+  // submitting it repeats the last rendered frame
+  bool hold = false;
+
+  glm::mat4 viewProjection{1.0f};
+  std::vector<TextCharacterGPU> characters;
+
+  // morphs are interpolated on the GPU when the frame is drawn
+  struct MorphDraw
+  {
+    TextMorph* morph;
+    float progress;
+  };
+  std::vector<MorphDraw> morphs;
+
+  // outlines being written, revealed on the GPU as well
+  struct StrokeDraw
+  {
+    TextStroke* stroke;
+    glm::mat4 transform;
+    glm::vec4 color;
+    float progress;
+  };
+  std::vector<StrokeDraw> strokes;
+
+  void reset(uint64_t frame, double time)
+  {
+    this->frame = frame;
+    this->time = time;
+    hold = false;
+    characters.clear();
+    morphs.clear();
+    strokes.clear();
+  }
+
+  void setCamera(const Camera& camera)
+  {
+    viewProjection = camera.viewProjection();
+  }
+
+  void addText(Text& text)
+  {
+    for (auto& character : text._characters)
+    {
+      characters.emplace_back(character.data());
+    }
+  }
+
+  void addText(NumberText& number)
+  {
+    for (size_t i = 0; i < number._length; i++)
+    {
+      characters.emplace_back(number._characters[i].data());
+    }
+  }
+
+  void addMorph(TextMorph& morph, float progress)
+  {
+    morphs.push_back({&morph, progress});
+  }
+
+  void addStroke(TextStroke& stroke, Text& text, float progress)
+  {
+    strokes.push_back({
+      &stroke,
+      text.transform.matrix(),
+      glm::vec4(text.color(), text.opacity()),
+      progress,
+    });
+  }
+};
+}  // namespace graphics
@@ -0,0 +1,135 @@
+#include "glyph_outlines.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace graphics
+{
+// flattening a single curve into more segments than this is never visible
+constexpr uint32_t maxCurveSegments = 64;
+
+GlyphOutlines::GlyphOutlines(
+  const std::filesystem::path& path,
+  float emSize,
+  float tolerance
+)
+  : _font(path), _scale(emSize / _font.unitsPerEm()), _tolerance(tolerance)
+{
+}
+
+const FlattenedGlyph& GlyphOutlines::glyph(uint32_t codepoint)
+{
+  auto it = _glyphs.find(codepoint);
+  if (it != _glyphs.end())
+  {
+    return it->second;
+  }
+
+  FlattenedGlyph glyph{};
+  for (const auto& contour : _font.outline(codepoint))
+  {
+    if (contour.empty())
+    {
+      continue;
+    }
+    glyph.contourStarts.push_back((uint32_t)glyph.points.size());
+    flatten(contour, glyph);
+  }
+  glyph.contourStarts.push_back((uint32_t)glyph.points.size());
+
+  return _glyphs.emplace(codepoint, std::move(glyph)).first->second;
+}
+
+void GlyphOutlines::flatten(
+  const OutlineContour& contour,
+  FlattenedGlyph& glyph
+) const
+{
+  size_t count = contour.size();
+  auto point = [&](size_t i) { return contour[i % count].position * _scale; };
+  auto onCurve = [&](size_t i) { return contour[i % count].onCurve; };
+
+  // start at an on curve point, or between two control points if there is
+  // none
+  size_t first = 0;
+  while (first < count && !onCurve(first))
+  {
+    first++;
+  }
+
+  glm::vec2 start = first < count ? point(first)
+                                  : (point(0) + point(1)) * 0.5f;
+  if (first == count)
+  {
+    first = 0;
+  }
+
+  addPoint(start, glyph);
+  glm::vec2 current = start;
+  for (size_t i = 1; i <= count; i++)
+  {
+    size_t index = first + i;
+    if (onCurve(index))
+    {
+      addPoint(point(index), glyph);
+      current = point(index);
+      continue;
+    }
+
+    // consecutive control points imply an on curve point between them
+    glm::vec2 control = point(index);
+    glm::vec2 end = onCurve(index + 1)
+                      ? point(index + 1)
+                      : (control + point(index + 1)) * 0.5f;
+
+    addQuadratic(current, control, end, glyph);
+    current = end;
+    if (onCurve(index + 1))
+    {
+      i++;
+    }
+  }
+
+  // close the contour
+  if (current.x != start.x || current.y != start.y)
+  {
+    addPoint(start, glyph);
+  }
+}
+
+void GlyphOutlines::addQuadratic(
+  const glm::vec2& start,
+  const glm::vec2& control,
+  const glm::vec2& end,
+  FlattenedGlyph& glyph
+) const
+{
+  // the distance between a quadratic curve and n uniform chords is bounded
+  // by |p0 - 2 p1 + p2| / (4 n^2)
+  float deviation = glm::length(start - control * 2.0f + end);
+  uint32_t segments = (uint32_t)std::ceil(
+    std::sqrt(deviation / (4.0f * std::max(_tolerance, 1e-6f)))
+  );
+  segments = std::clamp(segments, 1u, maxCurveSegments);
+
+  for (uint32_t s = 1; s <= segments; s++)
+  {
+    float t = (float)s / (float)segments;
+    glm::vec2 a = glm::mix(start, control, t);
+    glm::vec2 b = glm::mix(control, end, t);
+    addPoint(glm::mix(a, b, t), glyph);
+  }
+}
+
+void GlyphOutlines::addPoint(const glm::vec2& point, FlattenedGlyph& glyph)
+  const
+{
+  bool contourStart = glyph.points.size() == glyph.contourStarts.back();
+  if (!contourStart)
+  {
+    glyph.length += glm::distance(glyph.points.back(), point);
+  }
+  glyph.points.push_back(point);
+  glyph.lengths.push_back(glyph.length);
+}
+}  // namespace graphics
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/truetype.h"
+
+namespace graphics
+{
+// Glyph outline flattened into closed polylines. Every point stores the arc
+// length from the start of the glyph, contours follow each other.
+struct FlattenedGlyph
+{
+  std::vector<glm::vec2> points;
+  std::vector<float> lengths;
+  // index of the first point of every contour, plus the point count
+  std::vector<uint32_t> contourStarts;
+
+  float length = 0.0f;
+};
+
+// Flattened outlines of a TrueType font, each glyph is flattened once and
+// cached, so repeated letters cost nothing.
+class GlyphOutlines
+{
+ public:
+  // emSize is the size of the em square in layout units, tolerance is the
+  // maximum distance of the polylines from the curves in layout units
+  GlyphOutlines(
+    const std::filesystem::path& path,
+    float emSize,
+    float tolerance = 0.0005f
+  );
+  ~GlyphOutlines() = default;
+
+  const FlattenedGlyph& glyph(uint32_t codepoint);
+
+  const TrueTypeFont& font() const
+  {
+    return _font;
+  }
+
+  size_t cachedGlyphCount() const
+  {
+    return _glyphs.size();
+  }
+
+ private:
+  void flatten(const OutlineContour& contour, FlattenedGlyph& glyph) const;
+  void addQuadratic(
+    const glm::vec2& start,
+    const glm::vec2& control,
+    const glm::vec2& end,
+    FlattenedGlyph& glyph
+  ) const;
+  void addPoint(const glm::vec2& point, FlattenedGlyph& glyph) const;
+
+ private:
+  TrueTypeFont _font;
+  float _scale;
+  float _tolerance;
+
+  std::unordered_map<uint32_t, FlattenedGlyph> _glyphs;
+};
+}  // namespace graphics
@@ -0,0 +1,244 @@
+#include "gpu_timer.h"
+
+#include <iostream>
+#include <string>
+
+#include "util/profiler.h"
+
+namespace graphics
+{
+GpuTimer::GpuTimer(const wgpu::Device& device)
+  : _supported(device.HasFeature(wgpu::FeatureName::TimestampQuery)),
+    _device(device)
+{
+  if (!_supported)
+  {
+    std::cerr << "[WebGPU] Timestamp queries are not supported, GPU pass "
+                 "timings are disabled"
+              << std::endl;
+    return;
+  }
+
+  createSlots();
+
+  // timings which are not cleared in time are dropped instead of growing
+  _timings.reserve(slotCount * maxPasses);
+}
+
+GpuTimer::~GpuTimer()
+{
+  // destroying a buffer aborts its pending map, so no callback runs after
+  // the slots are gone
+  for (auto& slot : _slots)
+  {
+    if (slot.state == SlotState::Mapping)
+    {
+      slot.readbackBuffer.Destroy();
+    }
+  }
+}
+
+bool GpuTimer::begin()
+{
+  _active = nullptr;
+  if (!_supported)
+  {
+    return false;
+  }
+
+  // oldest first, so the timings are in submission order
+  bool collected = false;
+  for (uint32_t i = 0; i < slotCount; i++)
+  {
+    auto& slot = _slots[(_next + i) % slotCount];
+    if (slot.state == SlotState::Mapping &&
+        slot.mapStatus.load(std::memory_order_acquire) != MapStatus::Pending)
+    {
+      collected |= collect(slot);
+    }
+  }
+
+  auto& slot = _slots[_next];
+  if (slot.state == SlotState::Free)
+  {
+    slot.state = SlotState::Recording;
+    slot.passCount = 0;
+    _active = &slot;
+  }
+  return collected;
+}
+
+const wgpu::RenderPassTimestampWrites* GpuTimer::renderPass(const char* name)
+{
+  uint32_t pass = nextPass(name);
+  return pass < maxPasses ? &_active->renderWrites[pass] : nullptr;
+}
+
+const wgpu::ComputePassTimestampWrites* GpuTimer::computePass(const char* name)
+{
+  uint32_t pass = nextPass(name);
+  return pass < maxPasses ? &_active->computeWrites[pass] : nullptr;
+}
+
+void GpuTimer::resolve(const wgpu::CommandEncoder& encoder)
+{
+  if (!_active || _active->passCount == 0)
+  {
+    return;
+  }
+
+  uint32_t queryCount = _active->passCount * 2;
+  encoder.ResolveQuerySet(
+    _active->querySet,
+    0,
+    queryCount,
+    _active->resolveBuffer,
+    0
+  );
+  encoder.CopyBufferToBuffer(
+    _active->resolveBuffer,
+    0,
+    _active->readbackBuffer,
+    0,
+    queryCount * sizeof(uint64_t)
+  );
+}
+
+void GpuTimer::submitted()
+{
+  if (!_active)
+  {
+    return;
+  }
+
+  auto& slot = *_active;
+  _active = nullptr;
+
+  if (slot.passCount == 0)
+  {
+    slot.state = SlotState::Free;
+    return;
+  }
+
+  slot.state = SlotState::Mapping;
+  slot.mapStatus.store(MapStatus::Pending, std::memory_order_relaxed);
+  slot.submitted = util::Profiler::now();
+  slot.captured = util::Profiler::capturing();
+  _next = (_next + 1) % slotCount;
+
+  // may complete on any thread, the slot is only read after the status
+  slot.readbackBuffer.MapAsync(
+    wgpu::MapMode::Read,
+    0,
+    slot.passCount * 2 * sizeof(uint64_t),
+    wgpu::CallbackMode::AllowSpontaneous,
+    [](wgpu::MapAsyncStatus status, wgpu::StringView, Slot* slot)
+    {
+      slot->mapStatus.store(
+        status == wgpu::MapAsyncStatus::Success ? MapStatus::Mapped
+                                                : MapStatus::Failed,
+        std::memory_order_release
+      );
+    },
+    &slot
+  );
+}
+
+void GpuTimer::createSlots()
+{
+  for (uint32_t i = 0; i < slotCount; i++)
+  {
+    auto& slot = _slots[i];
+    std::string index = std::to_string(i);
+
+    std::string querySetLabel = "GPU Timer Query Set " + index;
+    wgpu::QuerySetDescriptor querySetDescriptor{};
+    querySetDescriptor.label = querySetLabel.c_str();
+    querySetDescriptor.type = wgpu::QueryType::Timestamp;
+    querySetDescriptor.count = maxPasses * 2;
+    slot.querySet = _device.CreateQuerySet(&querySetDescriptor);
+
+    std::string resolveBufferLabel = "GPU Timer Resolve Buffer " + index;
+    wgpu::BufferDescriptor resolveBufferDescriptor{};
+    resolveBufferDescriptor.label = resolveBufferLabel.c_str();
+    resolveBufferDescriptor.size = maxPasses * 2 * sizeof(uint64_t);
+    resolveBufferDescriptor.usage =
+      wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc;
+    slot.resolveBuffer = _device.CreateBuffer(&resolveBufferDescriptor);
+
+    std::string readbackBufferLabel = "GPU Timer Readback Buffer " + index;
+    wgpu::BufferDescriptor readbackBufferDescriptor{};
+    readbackBufferDescriptor.label = readbackBufferLabel.c_str();
+    readbackBufferDescriptor.size = maxPasses * 2 * sizeof(uint64_t);
+    readbackBufferDescriptor.usage =
+      wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+    slot.readbackBuffer = _device.CreateBuffer(&readbackBufferDescriptor);
+
+    for (uint32_t pass = 0; pass < maxPasses; pass++)
+    {
+      slot.renderWrites[pass].querySet = slot.querySet;
+      slot.renderWrites[pass].beginningOfPassWriteIndex = pass * 2;
+      slot.renderWrites[pass].endOfPassWriteIndex = pass * 2 + 1;
+
+      slot.computeWrites[pass].querySet = slot.querySet;
+      slot.computeWrites[pass].beginningOfPassWriteIndex = pass * 2;
+      slot.computeWrites[pass].endOfPassWriteIndex = pass * 2 + 1;
+    }
+  }
+}
+
+uint32_t GpuTimer::nextPass(const char* name)
+{
+  if (!_active || _active->passCount == maxPasses)
+  {
+    return maxPasses;
+  }
+
+  uint32_t pass = _active->passCount++;
+  _active->names[pass] = name;
+  return pass;
+}
+
+bool GpuTimer::collect(Slot& slot)
+{
+  slot.state = SlotState::Free;
+  if (slot.mapStatus.load(std::memory_order_acquire) != MapStatus::Mapped)
+  {
+    return false;
+  }
+
+  const auto* timestamps = static_cast<const uint64_t*>(
+    slot.readbackBuffer
+      .GetConstMappedRange(0, slot.passCount * 2 * sizeof(uint64_t))
+  );
+
+  for (uint32_t pass = 0; pass < slot.passCount; pass++)
+  {
+    uint64_t begin = timestamps[pass * 2];
+    uint64_t end = timestamps[pass * 2 + 1];
+
+    // timestamps may be reset between passes, e.g. on power state changes
+    uint64_t nanoseconds = end > begin ? end - begin : 0;
+    if (_timings.size() < _timings.capacity())
+    {
+      _timings.push_back({slot.names[pass], nanoseconds});
+    }
+
+    // the GPU clock is unrelated to the CPU one, passes are placed at the
+    // submission, offset by their distance to the first pass
+    if (slot.captured)
+    {
+      uint64_t offset = begin > timestamps[0] ? begin - timestamps[0] : 0;
+      uint64_t start = slot.submitted + util::Profiler::ticks(offset);
+      util::Profiler::recordGpu(
+        slot.names[pass],
+        start,
+        start + util::Profiler::ticks(nanoseconds)
+      );
+    }
+  }
+
+  slot.readbackBuffer.Unmap();
+  return true;
+}
+}  // namespace graphics
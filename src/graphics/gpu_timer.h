@@ -0,0 +1,126 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace graphics
+{
+struct GpuPassTiming
+{
+  const char* name;
+  uint64_t nanoseconds;
+};
+
+// Measures the GPU time of render and compute passes with timestamp queries.
+//
+// Every command encoder gets a slot with its own query set and readback
+// buffer. Slots are mapped asynchronously once their work was submitted and
+// collected by a later begin(), so reading the timings never stalls the
+// queue. If all slots are still in flight the encoder is not timed.
+//
+// Without the timestamp query feature every call is a no-op and the pass
+// timestamp writes are null.
+class GpuTimer
+{
+ public:
+  static constexpr uint32_t maxPasses = 8;
+
+  // the renderer flushes and the compute passes of particles, morphs and the
+  // YUV conversion each take a slot, for about two frames in flight
+  static constexpr uint32_t slotCount = 16;
+
+  GpuTimer(const wgpu::Device& device);
+  ~GpuTimer();
+
+  GpuTimer(const GpuTimer&) = delete;
+  GpuTimer& operator=(const GpuTimer&) = delete;
+
+  bool supported() const
+  {
+    return _supported;
+  }
+
+  // starts timing the passes of a command encoder, collects finished slots.
+  // Returns true if that added timings.
+  bool begin();
+
+  // timestamp writes for the next pass, null if the pass is not timed.
+  // name has to outlive the timer, e.g. a string literal.
+  const wgpu::RenderPassTimestampWrites* renderPass(const char* name);
+  const wgpu::ComputePassTimestampWrites* computePass(const char* name);
+
+  // resolves the timestamps of the encoder into the readback buffer
+  void resolve(const wgpu::CommandEncoder& encoder);
+
+  // call once the encoder has been submitted
+  void submitted();
+
+  // durations of the passes collected since the last clearTimings, in
+  // submission order
+  const std::vector<GpuPassTiming>& timings() const
+  {
+    return _timings;
+  }
+
+  void clearTimings()
+  {
+    _timings.clear();
+  }
+
+ private:
+  enum class SlotState
+  {
+    Free,
+    Recording,
+    Mapping,
+  };
+
+  enum class MapStatus : uint32_t
+  {
+    Pending,
+    Mapped,
+    Failed,
+  };
+
+  struct Slot
+  {
+    wgpu::QuerySet querySet;
+    wgpu::Buffer resolveBuffer;
+    wgpu::Buffer readbackBuffer;
+
+    std::array<const char*, maxPasses> names{};
+    std::array<wgpu::RenderPassTimestampWrites, maxPasses> renderWrites{};
+    std::array<wgpu::ComputePassTimestampWrites, maxPasses> computeWrites{};
+    uint32_t passCount = 0;
+
+    SlotState state = SlotState::Free;
+    std::atomic<MapStatus> mapStatus = MapStatus::Pending;
+
+    // profiler ticks at submission, and whether the profiler was capturing
+    uint64_t submitted = 0;
+    bool captured = false;
+  };
+
+  void createSlots();
+
+  // index of the next pair of queries, or maxPasses if the pass is not timed
+  uint32_t nextPass(const char* name);
+
+  bool collect(Slot& slot);
+
+ private:
+  bool _supported = false;
+
+  std::array<Slot, slotCount> _slots;
+  uint32_t _next = 0;
+  Slot* _active = nullptr;
+
+  std::vector<GpuPassTiming> _timings;
+
+  const wgpu::Device& _device;
+};
+}  // namespace graphics
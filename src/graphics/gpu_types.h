@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace graphics
@@ -8,8 +9,56 @@ struct TextCharacterGPU
 {
   alignas(16) glm::mat4 transform;
   alignas(16) glm::vec4 bounds;
-  alignas(16) glm::vec3 color;
+  alignas(16) glm::vec4 color;
   alignas(8) glm::vec2 size;
   alignas(8) glm::vec2 position;
+
+  // start time, stagger, duration, amplitude
+  alignas(16) glm::vec4 effect;
+  uint32_t effectType = 0;
+  uint32_t effectEasing = 0;
+  uint32_t index = 0;
+};
+
+struct TextUniformsGPU
+{
+  alignas(16) glm::mat4 viewProjection;
+  float time;
+};
+
+struct StrokeSegmentGPU
+{
+  alignas(8) glm::vec2 start;
+  alignas(8) glm::vec2 end;
+  // arc length at the start and the end of the segment
+  alignas(8) glm::vec2 lengths;
+};
+
+struct StrokeUniformsGPU
+{
+  alignas(16) glm::mat4 transform;
+  alignas(16) glm::vec4 color;
+  float reveal;
+  float thickness;
+};
+
+struct ParticleGPU
+{
+  alignas(16) glm::vec3 position;
+  float angle;
+  alignas(16) glm::vec3 velocity;
+  float angularVelocity;
+  float scale;
+};
+
+struct ParticleUniformsGPU
+{
+  alignas(16) glm::vec3 gravity;
+  float drag;
+  float deltaTime;
+  uint32_t particleCount;
+  uint32_t attractorCount;
+  // xyz position, w strength
+  alignas(16) glm::vec4 attractors[4];
 };
 };  // namespace graphics
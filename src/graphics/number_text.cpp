@@ -0,0 +1,226 @@
+#include "number_text.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace graphics
+{
+constexpr std::string_view numberCharacters = "0123456789,.-";
+constexpr uint32_t maxDecimals = 9;
+// larger values would not fit into the buffer
+constexpr double maxUnits = 1e18;
+
+NumberText::NumberText(const Font& font, uint32_t decimals, bool separators)
+  : _decimals(std::min(decimals, maxDecimals)),
+    _separators(separators),
+    _lineHeight(font.lineHeight() * Text::scalingFactor),
+    _base(font.base() * Text::scalingFactor)
+{
+  for (char c : numberCharacters)
+  {
+    const auto& fontChar = font.character(c);
+    auto& glyph = _glyphs[(unsigned char)c];
+    glyph.bounds = glm::vec4(
+      fontChar.bounds.left,
+      fontChar.bounds.right,
+      fontChar.bounds.top,
+      fontChar.bounds.bottom
+    );
+    glyph.size = fontChar.size * Text::scalingFactor;
+    glyph.offset = fontChar.offset * Text::scalingFactor;
+    glyph.advance = (float)fontChar.advance * Text::scalingFactor;
+  }
+
+  for (size_t i = 0; i < maxLength; i++)
+  {
+    auto& character = _characters[i];
+    character.transform.setParent(&transform);
+    character._data.color = glm::vec4(_color, _opacity);
+    character._data.index = (uint32_t)i;
+  }
+
+  // force the initial layout
+  _length = format(0.0, _buffer);
+  layout(0);
+  recalculateAlignment();
+}
+
+void NumberText::setValue(double value)
+{
+  _value = value;
+
+  size_t length = format(value, _scratch);
+  size_t first = 0;
+  while (first < length && first < _length && _scratch[first] == _buffer[first])
+  {
+    first++;
+  }
+
+  if (first == length && length == _length)
+  {
+    return;
+  }
+
+  std::copy(
+    _scratch.begin() + first,
+    _scratch.begin() + length,
+    _buffer.begin() + first
+  );
+  _length = length;
+  _revision++;
+  layout(first);
+}
+
+void NumberText::setAlignment(TextAlignment alignment)
+{
+  if (_alignment == alignment)
+  {
+    return;
+  }
+
+  _alignment = alignment;
+  _revision++;
+  recalculateAlignment();
+}
+
+void NumberText::setColor(const glm::vec3& color)
+{
+  if (_color == color)
+  {
+    return;
+  }
+
+  _color = color;
+  _revision++;
+  for (auto& character : _characters)
+  {
+    character._data.color = glm::vec4(color, _opacity);
+  }
+}
+
+void NumberText::setOpacity(float opacity)
+{
+  if (_opacity == opacity)
+  {
+    return;
+  }
+
+  _opacity = opacity;
+  _revision++;
+  for (auto& character : _characters)
+  {
+    character._data.color.a = opacity;
+  }
+}
+
+size_t NumberText::format(double value, std::array<char, maxLength>& buffer)
+  const
+{
+  uint64_t scale = 1;
+  for (uint32_t i = 0; i < _decimals; i++)
+  {
+    scale *= 10;
+  }
+
+  double scaled = std::round(std::abs(value) * (double)scale);
+  uint64_t units = (uint64_t)std::min(scaled, maxUnits);
+  uint64_t integer = units / scale;
+  uint64_t fraction = units % scale;
+
+  std::array<char, 24> digits;
+  size_t digitCount =
+    std::to_chars(digits.data(), digits.data() + digits.size(), integer).ptr -
+    digits.data();
+
+  size_t length = 0;
+  if (value < 0.0 && units != 0)
+  {
+    buffer[length++] = '-';
+  }
+
+  for (size_t i = 0; i < digitCount; i++)
+  {
+    if (_separators && i > 0 && (digitCount - i) % 3 == 0)
+    {
+      buffer[length++] = ',';
+    }
+    buffer[length++] = digits[i];
+  }
+
+  if (_decimals == 0)
+  {
+    return length;
+  }
+
+  buffer[length++] = '.';
+  size_t fractionCount =
+    std::to_chars(digits.data(), digits.data() + digits.size(), fraction).ptr -
+    digits.data();
+  for (size_t i = fractionCount; i < _decimals; i++)
+  {
+    buffer[length++] = '0';
+  }
+  for (size_t i = 0; i < fractionCount; i++)
+  {
+    buffer[length++] = digits[i];
+  }
+  return length;
+}
+
+void NumberText::layout(size_t first)
+{
+  for (size_t i = first; i < _length; i++)
+  {
+    const auto& glyph = _glyphs[(unsigned char)_buffer[i]];
+    auto& character = _characters[i];
+
+    character._codepoint = (unsigned char)_buffer[i];
+    character._data.bounds = glyph.bounds;
+    character._data.size = glyph.size;
+    character._data.position =
+      glm::vec2(_pens[i] + glyph.offset.x, -glyph.offset.y);
+    character._origin = glm::vec2(_pens[i], -_base);
+    character.transform.setOrigin(glm::vec3(
+      character._data.position.x + glyph.size.x / 2.0f,
+      character._data.position.y - glyph.size.y / 2.0f,
+      0.0f
+    ));
+
+    _pens[i + 1] = _pens[i] + glyph.advance;
+  }
+
+  float width = _pens[_length];
+  if (width != _width)
+  {
+    _width = width;
+    recalculateAlignment();
+  }
+}
+
+void NumberText::recalculateAlignment()
+{
+  float halfLineHeight = _lineHeight / 2.0f;
+
+  glm::vec2 offset{0.0f, halfLineHeight};
+  switch (_alignment)
+  {
+    case TextAlignment::Left:
+      break;
+
+    case TextAlignment::Centered:
+      offset.x = -_width / 2.0f;
+      break;
+
+    case TextAlignment::Right:
+      offset.x = -_width;
+      break;
+  }
+
+  transform.setOrigin(glm::vec3(-offset.x, -halfLineHeight, 0.0f));
+  for (auto& character : _characters)
+  {
+    character._offset = offset;
+  }
+}
+}  // namespace graphics
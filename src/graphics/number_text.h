@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string_view>
+
+#include "graphics/font.h"
+#include "graphics/text.h"
+#include "util/transform.h"
+
+namespace graphics
+{
+// Text showing a number, meant for counters animated every frame.
+//
+// The number is formatted into a fixed buffer and the glyph instances live
+// in a fixed array, so updating the value never allocates. Only glyphs whose
+// character or position changed are touched, digit metrics are looked up
+// once on construction.
+class NumberText
+{
+ public:
+  static constexpr size_t maxLength = 32;
+
+  NumberText(const Font& font, uint32_t decimals = 0, bool separators = true);
+  ~NumberText() = default;
+
+  // the glyphs keep pointers to the transform
+  NumberText(const NumberText&) = delete;
+  NumberText& operator=(const NumberText&) = delete;
+
+  double value() const
+  {
+    return _value;
+  }
+  void setValue(double value);
+
+  TextAlignment alignment() const
+  {
+    return _alignment;
+  }
+  void setAlignment(TextAlignment alignment);
+
+  const glm::vec3& color() const
+  {
+    return _color;
+  }
+  void setColor(const glm::vec3& color);
+
+  float opacity() const
+  {
+    return _opacity;
+  }
+  void setOpacity(float opacity);
+
+  std::string_view text() const
+  {
+    return std::string_view(_buffer.data(), _length);
+  }
+
+  size_t characterCount() const
+  {
+    return _length;
+  }
+
+  TextCharacter& character(size_t index)
+  {
+    return _characters.at(index);
+  }
+
+  float width() const
+  {
+    return _width;
+  }
+
+  // changes with every visible modification of the number or its transform
+  uint64_t revision() const
+  {
+    return _revision + transform.revision();
+  }
+
+ public:
+  util::Transform transform;
+
+ private:
+  struct Glyph
+  {
+    glm::vec4 bounds{0.0f};
+    glm::vec2 size{0.0f};
+    glm::vec2 offset{0.0f};
+    float advance = 0.0f;
+  };
+
+  size_t format(double value, std::array<char, maxLength>& buffer) const;
+
+  void layout(size_t first);
+  void recalculateAlignment();
+
+ private:
+  uint32_t _decimals;
+  bool _separators;
+  double _value = 0.0;
+
+  TextAlignment _alignment = TextAlignment::Left;
+  glm::vec3 _color{1.0f};
+  float _opacity = 1.0f;
+  float _lineHeight;
+  float _base;
+
+  // metrics of the characters a number can contain, indexed by ascii
+  std::array<Glyph, 128> _glyphs{};
+
+  std::array<char, maxLength> _buffer{};
+  std::array<char, maxLength> _scratch{};
+  size_t _length = 0;
+
+  std::array<TextCharacter, maxLength> _characters;
+  std::array<float, maxLength + 1> _pens{};
+  float _width = 0.0f;
+
+  uint64_t _revision = 0;
+
+  friend struct FrameData;
+};
+}  // namespace graphics
@@ -0,0 +1,349 @@
+#include "particle_system.h"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace graphics
+{
+constexpr uint32_t workgroupSize = 64;
+
+ParticleSystem::ParticleSystem(
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  Renderer& renderer,
+  uint32_t capacity,
+  uint32_t seed
+)
+  : _capacity(capacity),
+    _random(seed),
+    _stats(renderer.stats()),
+    _gpuTimer(renderer.gpuTimer()),
+    _device(device),
+    _queue(queue)
+{
+  createBuffers();
+  createPipeline();
+  _renderBindGroup = renderer.createTextBindGroup(_characterBuffer);
+}
+
+void ParticleSystem::emit(Text& text, const ParticleEmitSettings& settings)
+{
+  size_t glyphCount = text.characters().size();
+  if (glyphCount == 0 || settings.copies == 0)
+  {
+    return;
+  }
+
+  auto glyphCenter = [&](const TextCharacterGPU& data)
+  {
+    glm::vec2 center = data.position + data.size * glm::vec2(0.5f, -0.5f);
+    return glm::vec3(data.transform * glm::vec4(center, 0.0f, 1.0f));
+  };
+
+  glm::vec3 textCenter{0.0f};
+  for (size_t i = 0; i < glyphCount; i++)
+  {
+    textCenter += glyphCenter(text.character(i).data());
+  }
+  textCenter /= (float)glyphCount;
+
+  size_t total = std::min<size_t>(glyphCount * settings.copies, _capacity);
+  _emitParticles.clear();
+  _emitCharacters.clear();
+  _emitParticles.reserve(total);
+  _emitCharacters.reserve(total);
+
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  for (size_t i = 0; i < total; i++)
+  {
+    const auto& data = text.character(i % glyphCount).data();
+
+    auto& particle = _emitParticles.emplace_back();
+    particle.position = glyphCenter(data);
+    particle.angle = 0.0f;
+    particle.scale = glm::length(glm::vec3(data.transform[0]));
+
+    glm::vec3 jitter(unit(_random), unit(_random), unit(_random));
+    glm::vec3 direction = particle.position - textCenter;
+    direction += jitter * settings.spread;
+    if (glm::dot(direction, direction) > 0.0f)
+    {
+      direction = glm::normalize(direction);
+    }
+    float speed = settings.speed * (0.75f + 0.25f * unit(_random));
+    particle.velocity = direction * speed;
+    particle.angularVelocity = settings.spin * unit(_random);
+
+    // the quad is centered on the particle so it spins around its middle
+    auto& character = _emitCharacters.emplace_back(data);
+    character.position = data.size * glm::vec2(-0.5f, 0.5f);
+    character.effectType = 0;
+    character.transform = glm::scale(
+      glm::translate(glm::mat4(1.0f), particle.position),
+      glm::vec3(particle.scale)
+    );
+  }
+
+  uint32_t source = 0;
+  while (source < total)
+  {
+    uint32_t count = std::min<uint32_t>(total - source, _capacity - _next);
+    upload(_next, count, source);
+
+    source += count;
+    _next = (_next + count) % _capacity;
+  }
+  _count = std::min<uint32_t>(_count + (uint32_t)total, _capacity);
+  _lifetime = std::max(_lifetime, settings.lifetime);
+}
+
+void ParticleSystem::update(float deltaTime)
+{
+  if (_count == 0)
+  {
+    return;
+  }
+
+  _lifetime -= deltaTime;
+  if (_lifetime <= 0.0f)
+  {
+    clear();
+    return;
+  }
+
+  ParticleUniformsGPU uniforms{};
+  uniforms.gravity = _forces.gravity;
+  uniforms.drag = _forces.drag;
+  uniforms.deltaTime = deltaTime;
+  uniforms.particleCount = _count;
+  uniforms.attractorCount =
+    std::min<uint32_t>(_forces.attractorCount, _forces.attractors.size());
+  std::copy(
+    _forces.attractors.begin(),
+    _forces.attractors.end(),
+    uniforms.attractors
+  );
+  _queue.WriteBuffer(_uniformBuffer, 0, &uniforms, sizeof(uniforms));
+  _stats.upload(sizeof(uniforms));
+
+  wgpu::CommandEncoderDescriptor encoderDescriptor{};
+  encoderDescriptor.label = "Particle System Command Encoder";
+  auto encoder = _device.CreateCommandEncoder(&encoderDescriptor);
+  _gpuTimer.begin();
+
+  wgpu::ComputePassDescriptor computePassDescriptor{};
+  computePassDescriptor.label = "Particle System Compute Pass";
+  computePassDescriptor.timestampWrites =
+    _gpuTimer.computePass("Particle System Compute Pass");
+
+  auto computePass = encoder.BeginComputePass(&computePassDescriptor);
+  computePass.SetPipeline(_pipeline);
+  computePass.SetBindGroup(0, _computeBindGroup);
+  computePass.DispatchWorkgroups(
+    (_count + workgroupSize - 1) / workgroupSize,
+    1,
+    1
+  );
+  computePass.End();
+  _gpuTimer.resolve(encoder);
+
+  wgpu::CommandBufferDescriptor commandDescriptor{};
+  commandDescriptor.label = "Particle System Command Buffer";
+  auto command = encoder.Finish(&commandDescriptor);
+
+  _queue.Submit(1, &command);
+  _gpuTimer.submitted();
+}
+
+void ParticleSystem::draw(Renderer& renderer) const
+{
+  renderer.drawInstances(_renderBindGroup, _count);
+}
+
+void ParticleSystem::clear()
+{
+  _count = 0;
+  _next = 0;
+  _lifetime = 0.0f;
+}
+
+void ParticleSystem::setForces(const ParticleForces& forces)
+{
+  _forces = forces;
+}
+
+void ParticleSystem::upload(uint32_t first, uint32_t count, uint32_t source)
+{
+  _queue.WriteBuffer(
+    _particleBuffer,
+    first * sizeof(ParticleGPU),
+    _emitParticles.data() + source,
+    count * sizeof(ParticleGPU)
+  );
+  _queue.WriteBuffer(
+    _characterBuffer,
+    first * sizeof(TextCharacterGPU),
+    _emitCharacters.data() + source,
+    count * sizeof(TextCharacterGPU)
+  );
+  _stats.upload(count * (sizeof(ParticleGPU) + sizeof(TextCharacterGPU)));
+}
+
+void ParticleSystem::createBuffers()
+{
+  wgpu::BufferDescriptor particleBufferDescriptor{};
+  particleBufferDescriptor.label = "Particle System Particle Buffer";
+  particleBufferDescriptor.size = (uint64_t)_capacity * sizeof(ParticleGPU);
+  particleBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+  _particleBuffer = _device.CreateBuffer(&particleBufferDescriptor);
+
+  wgpu::BufferDescriptor characterBufferDescriptor{};
+  characterBufferDescriptor.label = "Particle System Character Buffer";
+  characterBufferDescriptor.size =
+    (uint64_t)_capacity * sizeof(TextCharacterGPU);
+  characterBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+  _characterBuffer = _device.CreateBuffer(&characterBufferDescriptor);
+
+  wgpu::BufferDescriptor uniformBufferDescriptor{};
+  uniformBufferDescriptor.label = "Particle System Uniform Buffer";
+  uniformBufferDescriptor.size = sizeof(ParticleUniformsGPU);
+  uniformBufferDescriptor.usage =
+    wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+  _uniformBuffer = _device.CreateBuffer(&uniformBufferDescriptor);
+}
+
+void ParticleSystem::createPipeline()
+{
+  std::array<wgpu::BindGroupLayoutEntry, 3> bindGroupLayoutEntries{};
+  bindGroupLayoutEntries[0].binding = 0;
+  bindGroupLayoutEntries[0].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[0].buffer.type = wgpu::BufferBindingType::Storage;
+
+  bindGroupLayoutEntries[1].binding = 1;
+  bindGroupLayoutEntries[1].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[1].buffer.type = wgpu::BufferBindingType::Storage;
+
+  bindGroupLayoutEntries[2].binding = 2;
+  bindGroupLayoutEntries[2].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[2].buffer.type = wgpu::BufferBindingType::Uniform;
+
+  wgpu::BindGroupLayoutDescriptor bindGroupLayoutDescriptor{};
+  bindGroupLayoutDescriptor.label = "Particle System Bind Group Layout";
+  bindGroupLayoutDescriptor.entryCount =
+    (uint32_t)bindGroupLayoutEntries.size();
+  bindGroupLayoutDescriptor.entries = bindGroupLayoutEntries.data();
+  auto bindGroupLayout =
+    _device.CreateBindGroupLayout(&bindGroupLayoutDescriptor);
+
+  std::array<wgpu::BindGroupEntry, 3> bindGroupEntries{};
+  bindGroupEntries[0].buffer = _particleBuffer;
+  bindGroupEntries[0].binding = 0;
+
+  bindGroupEntries[1].buffer = _characterBuffer;
+  bindGroupEntries[1].binding = 1;
+
+  bindGroupEntries[2].buffer = _uniformBuffer;
+  bindGroupEntries[2].binding = 2;
+
+  wgpu::BindGroupDescriptor bindGroupDescriptor{};
+  bindGroupDescriptor.label = "Particle System Bind Group";
+  bindGroupDescriptor.entryCount = bindGroupEntries.size();
+  bindGroupDescriptor.entries = bindGroupEntries.data();
+  bindGroupDescriptor.layout = bindGroupLayout;
+  _computeBindGroup = _device.CreateBindGroup(&bindGroupDescriptor);
+
+  const char* shaderCode = R"(
+    struct Particle {
+      position: vec3f,
+      angle: f32,
+      velocity: vec3f,
+      angularVelocity: f32,
+      scale: f32,
+    };
+
+    struct TextCharacter {
+      transform: mat4x4<f32>,
+      bounds: vec4f,
+      color: vec4f,
+      size: vec2f,
+      position: vec2f,
+      effect: vec4f,
+      effectType: u32,
+      effectEasing: u32,
+      index: u32,
+    };
+
+    struct Uniforms {
+      gravity: vec3f,
+      drag: f32,
+      deltaTime: f32,
+      particleCount: u32,
+      attractorCount: u32,
+      attractors: array<vec4f, 4>,
+    };
+
+    @group(0) @binding(0) var<storage, read_write> particles: array<Particle>;
+    @group(0) @binding(1) var<storage, read_write> characters: array<TextCharacter>;
+    @group(0) @binding(2) var<uniform> uniforms: Uniforms;
+
+    @compute @workgroup_size(64)
+    fn csMain(@builtin(global_invocation_id) id: vec3u) {
+      let i = id.x;
+      if (i >= uniforms.particleCount) {
+        return;
+      }
+
+      var p = particles[i];
+      let dt = uniforms.deltaTime;
+
+      var acceleration = uniforms.gravity;
+      for (var a = 0u; a < uniforms.attractorCount; a++) {
+        let attractor = uniforms.attractors[a];
+        let d = attractor.xyz - p.position;
+        let distanceSq = dot(d, d) + 0.01;
+        acceleration += attractor.w * d * inverseSqrt(distanceSq) / distanceSq;
+      }
+
+      p.velocity += acceleration * dt;
+      p.velocity *= exp(-uniforms.drag * dt);
+      p.position += p.velocity * dt;
+      p.angle += p.angularVelocity * dt;
+      particles[i] = p;
+
+      let c = cos(p.angle) * p.scale;
+      let s = sin(p.angle) * p.scale;
+      characters[i].transform = mat4x4<f32>(
+        vec4f(c, s, 0.0, 0.0),
+        vec4f(-s, c, 0.0, 0.0),
+        vec4f(0.0, 0.0, p.scale, 0.0),
+        vec4f(p.position, 1.0)
+      );
+    }
+)";
+
+  wgpu::ShaderModuleWGSLDescriptor wgslDescriptor{};
+  wgslDescriptor.code = shaderCode;
+  wgslDescriptor.sType = wgpu::SType::ShaderSourceWGSL;
+
+  wgpu::ShaderModuleDescriptor shaderModuleDescriptor{};
+  shaderModuleDescriptor.label = "Particle System Shader Module";
+  shaderModuleDescriptor.nextInChain = &wgslDescriptor;
+
+  wgpu::ShaderModule shaderModule =
+    _device.CreateShaderModule(&shaderModuleDescriptor);
+
+  wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{};
+  pipelineLayoutDescriptor.label = "Particle System Pipeline Layout";
+  pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
+  pipelineLayoutDescriptor.bindGroupLayouts = &bindGroupLayout;
+  auto pipelineLayout = _device.CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+  wgpu::ComputePipelineDescriptor pipelineDescriptor{};
+  pipelineDescriptor.label = "Particle System Pipeline";
+  pipelineDescriptor.compute.module = shaderModule;
+  pipelineDescriptor.layout = pipelineLayout;
+  _pipeline = _device.CreateComputePipeline(&pipelineDescriptor);
+}
+}  // namespace graphics
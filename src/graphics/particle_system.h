@@ -0,0 +1,114 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <random>
+#include <vector>
+
+#include "graphics/gpu_types.h"
+#include "graphics/renderer.h"
+#include "graphics/text.h"
+
+namespace graphics
+{
+struct ParticleForces
+{
+  glm::vec3 gravity{0.0f, -2.0f, 0.0f};
+  float drag = 0.5f;
+
+  // xyz position, w strength, negative strengths repel
+  std::array<glm::vec4, 4> attractors{};
+  uint32_t attractorCount = 0;
+};
+
+struct ParticleEmitSettings
+{
+  float speed = 2.0f;
+  float spread = 0.5f;
+  float spin = 4.0f;
+  // particles emitted per glyph
+  uint32_t copies = 1;
+
+  // seconds until the system is cleared, counted from the latest emit
+  float lifetime = 3.0f;
+};
+
+// Simulates glyph particles entirely on the GPU. A compute pass integrates
+// the particle state and writes the instance data of the text pipeline into
+// a storage buffer, which the renderer draws from without any readback.
+//
+// Emitting writes new particles into a ring, once the capacity is reached
+// the oldest particles are replaced. All particles are removed together,
+// once the lifetime of the latest emit has passed.
+class ParticleSystem
+{
+ public:
+  ParticleSystem(
+    const wgpu::Device& device,
+    const wgpu::Queue& queue,
+    Renderer& renderer,
+    uint32_t capacity,
+    uint32_t seed = 0
+  );
+  ~ParticleSystem() = default;
+
+  // spawns particles at the glyphs of the text flying away from its center
+  void emit(Text& text, const ParticleEmitSettings& settings);
+
+  void update(float deltaTime);
+
+  void draw(Renderer& renderer) const;
+
+  void clear();
+
+  const ParticleForces& forces() const
+  {
+    return _forces;
+  }
+  void setForces(const ParticleForces& forces);
+
+  uint32_t capacity() const
+  {
+    return _capacity;
+  }
+
+  uint32_t count() const
+  {
+    return _count;
+  }
+
+ private:
+  void createBuffers();
+  void createPipeline();
+
+  void upload(uint32_t first, uint32_t count, uint32_t source);
+
+ private:
+  uint32_t _capacity;
+  uint32_t _count = 0;
+  uint32_t _next = 0;
+  float _lifetime = 0.0f;
+
+  ParticleForces _forces;
+  std::mt19937 _random;
+
+  std::vector<ParticleGPU> _emitParticles;
+  std::vector<TextCharacterGPU> _emitCharacters;
+
+  wgpu::Buffer _particleBuffer;
+  wgpu::Buffer _characterBuffer;
+  wgpu::Buffer _uniformBuffer;
+  wgpu::BindGroup _computeBindGroup;
+  wgpu::BindGroup _renderBindGroup;
+  wgpu::ComputePipeline _pipeline;
+
+  RenderStats& _stats;
+  GpuTimer& _gpuTimer;
+
+  const wgpu::Device& _device;
+  const wgpu::Queue& _queue;
+};
+}  // namespace graphics
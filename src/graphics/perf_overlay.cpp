@@ -0,0 +1,302 @@
+#include "perf_overlay.h"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "graphics/text.h"
+
+namespace graphics
+{
+constexpr float margin = 8.0f;
+constexpr float lineHeight = 16.0f;
+constexpr float rowHeight = 18.0f;
+constexpr float valueRight = margin + 72.0f;
+constexpr float labelLeft = valueRight + 8.0f;
+
+constexpr float graphHeight = 48.0f;
+constexpr float barWidth = 1.5f;
+// a full bar is two frames at 60 Hz
+constexpr double graphSeconds = 2.0 / 60.0;
+
+constexpr double refreshInterval = 0.25;
+
+const glm::vec4 panelColor{0.0f, 0.0f, 0.0f, 0.6f};
+const glm::vec3 textColor{1.0f};
+const glm::vec4 budgetColor{1.0f, 1.0f, 1.0f, 0.3f};
+
+struct ValueLayout
+{
+  const char* label;
+  uint32_t decimals;
+};
+
+constexpr std::array<ValueLayout, 6> valueLayouts = {{
+  {"fps", 0},
+  {"ms CPU", 2},
+  {"ms GPU", 2},
+  {"glyphs", 0},
+  {"KiB/frame uploaded", 1},
+  {"MiB frame cache", 1},
+}};
+
+static glm::vec4 barColor(double seconds)
+{
+  if (seconds <= 1.0 / 60.0)
+  {
+    return {0.3f, 0.9f, 0.4f, 1.0f};
+  }
+  if (seconds <= 2.0 / 60.0)
+  {
+    return {1.0f, 0.8f, 0.2f, 1.0f};
+  }
+  return {1.0f, 0.3f, 0.3f, 1.0f};
+}
+
+PerfOverlay::PerfOverlay(Renderer& renderer, uint32_t width, uint32_t height)
+  : _queue(renderer.queue())
+{
+  // the overlay is drawn with the text bind group, so its glyph bounds have
+  // to come from the font of the bound atlas
+  const auto& font = renderer.atlasFont();
+
+  const auto& bar = font.character('|');
+  glm::vec2 center{
+    (bar.bounds.left + bar.bounds.right) / 2.0f,
+    (bar.bounds.top + bar.bounds.bottom) / 2.0f,
+  };
+  glm::vec2 extent{
+    (bar.bounds.right - bar.bounds.left) * 0.01f,
+    (bar.bounds.bottom - bar.bounds.top) * 0.01f,
+  };
+  _solidBounds = glm::vec4(
+    center.x - extent.x,
+    center.x + extent.x,
+    center.y - extent.y,
+    center.y + extent.y
+  );
+
+  float graphTop = margin + valueLayouts.size() * rowHeight + 6.0f;
+  float panelWidth = std::max(
+    labelLeft + 150.0f,
+    margin + graphBarCount * barWidth + margin
+  );
+  _instances.push_back(rectangle(
+    glm::vec2(margin / 2.0f),
+    glm::vec2(panelWidth, graphTop + graphHeight + margin / 2.0f),
+    panelColor
+  ));
+
+  // target line of a 60 Hz frame
+  _instances.push_back(rectangle(
+    glm::vec2(margin, graphTop + graphHeight / 2.0f),
+    glm::vec2(graphBarCount * barWidth, 1.0f),
+    budgetColor
+  ));
+
+  for (size_t i = 0; i < valueLayouts.size(); i++)
+  {
+    float rowCenter = margin + (i + 0.5f) * rowHeight;
+    addLabel(font, valueLayouts[i].label, glm::vec2(labelLeft, rowCenter));
+  }
+
+  float scale = lineHeight / (font.lineHeight() * Text::scalingFactor);
+  _valueFirst = _instances.size();
+  for (size_t i = 0; i < ValueCount; i++)
+  {
+    auto& value = _values[i];
+    value = std::make_unique<NumberText>(font, valueLayouts[i].decimals);
+    value->setAlignment(TextAlignment::Right);
+    value->setColor(textColor);
+    value->transform.setPosition(
+      glm::vec3(valueRight, -(margin + (i + 0.5f) * rowHeight), 0.0f)
+    );
+    value->transform.setScale(glm::vec3(scale, scale, 1.0f));
+    _valueRevisions[i] = value->revision() - 1;
+  }
+  _instances.resize(_instances.size() + ValueCount * NumberText::maxLength);
+
+  _graphFirst = _instances.size();
+  for (size_t i = 0; i < graphBarCount; i++)
+  {
+    _instances.push_back(rectangle(
+      glm::vec2(margin + i * barWidth, graphTop + graphHeight),
+      glm::vec2(barWidth, 0.0f),
+      barColor(0.0)
+    ));
+  }
+
+  createBuffers(renderer);
+  resize(width, height);
+  refreshValues();
+  writeInstances(0, _instances.size());
+
+  _refreshTime = std::chrono::steady_clock::now();
+}
+
+void PerfOverlay::resize(uint32_t width, uint32_t height)
+{
+  // pixels with the origin in the top left corner, y pointing up like the
+  // glyph quads
+  TextUniformsGPU uniforms{};
+  uniforms.viewProjection =
+    glm::ortho(0.0f, (float)width, -(float)height, 0.0f, -1.0f, 1.0f);
+  _queue.WriteBuffer(_uniformBuffer, 0, &uniforms, sizeof(uniforms));
+}
+
+void PerfOverlay::update(const RenderStats& stats, uint64_t memoryBytes)
+{
+  const auto& counters = stats.last();
+  double cpuSeconds = stats.lastCpuTime();
+
+  _frames++;
+  _cpuSeconds += cpuSeconds;
+  if (stats.lastGpuTime() >= 0.0)
+  {
+    _gpuSeconds += stats.lastGpuTime();
+    _gpuFrames++;
+  }
+  _counters.instances = counters.instances;
+  _counters.uploadBytes += counters.uploadBytes;
+  _memoryBytes = memoryBytes;
+
+  float graphTop = margin + valueLayouts.size() * rowHeight + 6.0f;
+  float height =
+    (float)std::min(cpuSeconds / graphSeconds, 1.0) * graphHeight;
+
+  _instances[_graphFirst + _graphNext] = rectangle(
+    glm::vec2(margin + _graphNext * barWidth, graphTop + graphHeight - height),
+    glm::vec2(barWidth, height),
+    barColor(cpuSeconds)
+  );
+  writeInstances(_graphFirst + _graphNext, 1);
+  _graphNext = (_graphNext + 1) % graphBarCount;
+
+  auto now = std::chrono::steady_clock::now();
+  double elapsed = std::chrono::duration<double>(now - _refreshTime).count();
+  if (elapsed < refreshInterval)
+  {
+    return;
+  }
+
+  _values[FrameRate]->setValue(_frames / elapsed);
+  _values[CpuTime]->setValue(_cpuSeconds / _frames * 1e3);
+  if (_gpuFrames > 0)
+  {
+    _values[GpuTime]->setValue(_gpuSeconds / _gpuFrames * 1e3);
+  }
+
+  // without the instances of the overlay itself
+  size_t ownInstances = _instances.size();
+  _values[Glyphs]->setValue(
+    _counters.instances > ownInstances ? _counters.instances - ownInstances : 0
+  );
+  _values[Upload]->setValue(_counters.uploadBytes / 1024.0 / _frames);
+  _values[Memory]->setValue(_memoryBytes / (1024.0 * 1024.0));
+  refreshValues();
+
+  _refreshTime = now;
+  _frames = 0;
+  _cpuSeconds = 0.0;
+  _gpuSeconds = 0.0;
+  _gpuFrames = 0;
+  _counters = {};
+}
+
+void PerfOverlay::draw(Renderer& renderer) const
+{
+  renderer.drawInstances(_bindGroup, (uint32_t)_instances.size());
+}
+
+void PerfOverlay::createBuffers(Renderer& renderer)
+{
+  const auto& device = renderer.device();
+
+  wgpu::BufferDescriptor characterBufferDescriptor{};
+  characterBufferDescriptor.label = "Perf Overlay Character Buffer";
+  characterBufferDescriptor.size = _instances.size() * sizeof(TextCharacterGPU);
+  characterBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+  _characterBuffer = device.CreateBuffer(&characterBufferDescriptor);
+
+  wgpu::BufferDescriptor uniformBufferDescriptor{};
+  uniformBufferDescriptor.label = "Perf Overlay Uniform Buffer";
+  uniformBufferDescriptor.size = sizeof(TextUniformsGPU);
+  uniformBufferDescriptor.usage =
+    wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+  _uniformBuffer = device.CreateBuffer(&uniformBufferDescriptor);
+
+  _bindGroup = renderer.createTextBindGroup(_characterBuffer, _uniformBuffer);
+}
+
+void PerfOverlay::addLabel(
+  const Font& font,
+  const char* label,
+  const glm::vec2& center
+)
+{
+  float scale = lineHeight / (font.lineHeight() * Text::scalingFactor);
+
+  auto text = Text(label, font);
+  text.setColor(textColor);
+  text.transform.setPosition(glm::vec3(center.x, -center.y, 0.0f));
+  text.transform.setScale(glm::vec3(scale, scale, 1.0f));
+  for (size_t i = 0; i < text.characters().size(); i++)
+  {
+    _instances.push_back(text.character(i).data());
+  }
+}
+
+TextCharacterGPU PerfOverlay::rectangle(
+  const glm::vec2& position,
+  const glm::vec2& size,
+  const glm::vec4& color
+) const
+{
+  TextCharacterGPU data{};
+  data.transform = glm::mat4(1.0f);
+  data.bounds = _solidBounds;
+  data.color = color;
+  data.size = size;
+  data.position = glm::vec2(position.x, -position.y);
+  return data;
+}
+
+void PerfOverlay::refreshValues()
+{
+  for (size_t i = 0; i < ValueCount; i++)
+  {
+    auto& value = *_values[i];
+    if (value.revision() == _valueRevisions[i])
+    {
+      continue;
+    }
+    _valueRevisions[i] = value.revision();
+
+    // unused glyphs collapse to nothing, so the instance count stays fixed
+    size_t first = _valueFirst + i * NumberText::maxLength;
+    for (size_t c = 0; c < NumberText::maxLength; c++)
+    {
+      auto& instance = _instances[first + c];
+      if (c < value.characterCount())
+      {
+        instance = value.character(c).data();
+      }
+      else
+      {
+        instance.size = glm::vec2(0.0f);
+      }
+    }
+    writeInstances(first, NumberText::maxLength);
+  }
+}
+
+void PerfOverlay::writeInstances(size_t first, size_t count)
+{
+  _queue.WriteBuffer(
+    _characterBuffer,
+    first * sizeof(TextCharacterGPU),
+    _instances.data() + first,
+    count * sizeof(TextCharacterGPU)
+  );
+}
+}  // namespace graphics
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "graphics/font.h"
+#include "graphics/gpu_types.h"
+#include "graphics/number_text.h"
+#include "graphics/render_stats.h"
+#include "graphics/renderer.h"
+
+namespace graphics
+{
+// Performance HUD in the top left corner of the window: frame rate, CPU and
+// GPU frame time, glyph count, uploaded bytes, memory use, and a graph of
+// the latest frame times.
+//
+// Drawn by the text pipeline as one instance draw in pixel space, with its
+// own character and uniform buffers. Labels are laid out once, the values
+// are NumberTexts refreshed a few times per second, and the graph sweeps
+// across its bars, so an update writes a single bar and, at most, the
+// glyphs of changed numbers. Nothing is allocated after construction.
+//
+// Draw it onto the presented image, not into the frame cache.
+class PerfOverlay
+{
+ public:
+  static constexpr size_t graphBarCount = 120;
+
+  PerfOverlay(Renderer& renderer, uint32_t width, uint32_t height);
+  ~PerfOverlay() = default;
+
+  // the numbers keep pointers to their own transforms
+  PerfOverlay(const PerfOverlay&) = delete;
+  PerfOverlay& operator=(const PerfOverlay&) = delete;
+
+  void resize(uint32_t width, uint32_t height);
+
+  // reads the last finished frame, memory is shown in MiB
+  void update(const RenderStats& stats, uint64_t memoryBytes);
+
+  void draw(Renderer& renderer) const;
+
+ private:
+  enum Value : size_t
+  {
+    FrameRate,
+    CpuTime,
+    GpuTime,
+    Glyphs,
+    Upload,
+    Memory,
+    ValueCount,
+  };
+
+  void createBuffers(Renderer& renderer);
+
+  void addLabel(const Font& font, const char* label, const glm::vec2& center);
+
+  // solid rectangle from its top left corner, in pixels
+  TextCharacterGPU rectangle(
+    const glm::vec2& position,
+    const glm::vec2& size,
+    const glm::vec4& color
+  ) const;
+
+  void refreshValues();
+  void writeInstances(size_t first, size_t count);
+
+ private:
+  // atlas coordinates in the middle of a stem, sampled by every pixel of a
+  // rectangle so it is fully inside the glyph
+  glm::vec4 _solidBounds{0.0f};
+
+  // panel and labels, values, graph bars
+  std::vector<TextCharacterGPU> _instances;
+  size_t _valueFirst = 0;
+  size_t _graphFirst = 0;
+
+  std::array<std::unique_ptr<NumberText>, ValueCount> _values;
+  std::array<uint64_t, ValueCount> _valueRevisions{};
+
+  size_t _graphNext = 0;
+
+  // accumulated since the values were last refreshed
+  std::chrono::steady_clock::time_point _refreshTime;
+  uint32_t _frames = 0;
+  double _cpuSeconds = 0.0;
+  double _gpuSeconds = 0.0;
+  uint32_t _gpuFrames = 0;
+  RenderCounters _counters;
+  uint64_t _memoryBytes = 0;
+
+  wgpu::Buffer _characterBuffer;
+  wgpu::Buffer _uniformBuffer;
+  wgpu::BindGroup _bindGroup;
+
+  const wgpu::Queue& _queue;
+};
+}  // namespace graphics
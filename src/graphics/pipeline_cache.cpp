@@ -0,0 +1,372 @@
+#include "pipeline_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+// set by the build from the Dawn package, entries of another Dawn build are
+// never loaded
+#ifndef TANIM_DAWN_VERSION
+#define TANIM_DAWN_VERSION "unknown"
+#endif
+
+namespace graphics
+{
+// stale temporaries are left behind by crashed writers
+constexpr auto temporaryLifetime = std::chrono::hours(1);
+
+struct EntryHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint64_t keySize;
+  uint64_t valueSize;
+};
+
+constexpr char entryMagic[4] = {'T', 'P', 'C', 'E'};
+constexpr uint32_t entryVersion = 1;
+
+static uint64_t hash(const void* data, size_t size)
+{
+  // FNV-1a
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t value = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++)
+  {
+    value = (value ^ bytes[i]) * 1099511628211ull;
+  }
+  return value;
+}
+
+static std::string hex(uint64_t value)
+{
+  std::ostringstream stream;
+  stream << std::hex << std::setw(16) << std::setfill('0') << value;
+  return stream.str();
+}
+
+PipelineCache::PipelineCache(std::filesystem::path directory, uint64_t budget)
+  : _root(std::move(directory)),
+    _budget(budget)
+{
+}
+
+std::filesystem::path PipelineCache::defaultDirectory()
+{
+  auto environment = [](const char* name) -> std::filesystem::path
+  {
+    const char* value = std::getenv(name);
+    return value && *value ? value : "";
+  };
+
+#if defined(_WIN32)
+  auto base = environment("LOCALAPPDATA");
+#elif defined(__APPLE__)
+  auto home = environment("HOME");
+  auto base = home.empty() ? home : home / "Library" / "Caches";
+#else
+  auto base = environment("XDG_CACHE_HOME");
+  if (base.empty() && !environment("HOME").empty())
+  {
+    base = environment("HOME") / ".cache";
+  }
+#endif
+
+  if (base.empty())
+  {
+    std::error_code error;
+    base = std::filesystem::temp_directory_path(error);
+  }
+  return base / "tanim" / "pipelines";
+}
+
+void PipelineCache::attach(
+  wgpu::DeviceDescriptor& descriptor,
+  const wgpu::Adapter& adapter
+)
+{
+  wgpu::AdapterInfo info{};
+  adapter.GetInfo(&info);
+
+  // Dawn mixes the key into its own keys as well
+  std::ostringstream isolationKey;
+  isolationKey << "tanim dawn-" << TANIM_DAWN_VERSION << " backend-"
+               << (uint32_t)info.backendType << " " << std::hex
+               << info.vendorID << ":" << info.deviceID << " "
+               << std::string_view(info.device) << " "
+               << std::string_view(info.description);
+  _isolationKey = isolationKey.str();
+  _directory =
+    _root / hex(hash(_isolationKey.data(), _isolationKey.size()));
+
+  std::error_code error;
+  std::filesystem::create_directories(_directory, error);
+  if (error)
+  {
+    std::cerr << "[PipelineCache] Could not create " << _directory.string()
+              << ", shaders are compiled on every launch: " << error.message()
+              << std::endl;
+    return;
+  }
+
+  {
+    std::lock_guard lock(_mutex);
+    trim();
+  }
+  _enabled = true;
+
+  _descriptor.isolationKey = _isolationKey.c_str();
+  _descriptor.loadDataFunction = loadData;
+  _descriptor.storeDataFunction = storeData;
+  _descriptor.functionUserdata = this;
+  _descriptor.nextInChain = descriptor.nextInChain;
+  descriptor.nextInChain = &_descriptor;
+}
+
+void PipelineCache::report() const
+{
+  if (!_enabled)
+  {
+    return;
+  }
+
+  std::lock_guard lock(_mutex);
+  std::cerr << "[PipelineCache] " << _hits << " hits, " << _misses
+            << " misses, " << _stores << " stored, " << std::fixed
+            << std::setprecision(1) << _size / (1024.0 * 1024.0) << " MiB in "
+            << _directory.string() << std::endl;
+}
+
+size_t PipelineCache::loadData(
+  const void* key,
+  size_t keySize,
+  void* value,
+  size_t valueSize,
+  void* userdata
+)
+{
+  return static_cast<PipelineCache*>(userdata)
+    ->load(key, keySize, value, valueSize);
+}
+
+void PipelineCache::storeData(
+  const void* key,
+  size_t keySize,
+  const void* value,
+  size_t valueSize,
+  void* userdata
+)
+{
+  static_cast<PipelineCache*>(userdata)->store(key, keySize, value, valueSize);
+}
+
+size_t PipelineCache::load(
+  const void* key,
+  size_t keySize,
+  void* value,
+  size_t valueSize
+)
+{
+  // Dawn asks for the size first and then for the data
+  bool query = !value || valueSize == 0;
+
+  auto path = entryPath(key, keySize);
+  std::ifstream file(path, std::ios::binary);
+
+  EntryHeader header{};
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!file || std::memcmp(header.magic, entryMagic, sizeof(entryMagic)) != 0 ||
+      header.version != entryVersion || header.keySize != keySize)
+  {
+    if (query)
+    {
+      _misses++;
+    }
+    return 0;
+  }
+
+  // the file name is only a hash of the key
+  std::vector<char> storedKey(keySize);
+  file.read(storedKey.data(), keySize);
+  if (!file || std::memcmp(storedKey.data(), key, keySize) != 0)
+  {
+    if (query)
+    {
+      _misses++;
+    }
+    return 0;
+  }
+
+  if (query)
+  {
+    return header.valueSize;
+  }
+  if (valueSize < header.valueSize)
+  {
+    return 0;
+  }
+
+  file.read(static_cast<char*>(value), header.valueSize);
+  if (!file)
+  {
+    return 0;
+  }
+  file.close();
+  _hits++;
+
+  // keeps the entry from being trimmed first
+  std::error_code error;
+  std::filesystem::last_write_time(
+    path,
+    std::filesystem::file_time_type::clock::now(),
+    error
+  );
+  return header.valueSize;
+}
+
+void PipelineCache::store(
+  const void* key,
+  size_t keySize,
+  const void* value,
+  size_t valueSize
+)
+{
+  uint64_t entrySize = sizeof(EntryHeader) + keySize + valueSize;
+  if (entrySize > _budget / 4)
+  {
+    return;
+  }
+
+  // unique across threads and, most likely, across processes sharing the
+  // directory
+  auto path = entryPath(key, keySize);
+  auto temporary = path;
+  temporary += ".tmp" +
+               std::to_string(
+                 std::chrono::steady_clock::now().time_since_epoch().count()
+               ) +
+               "-" + std::to_string(_nextTemporary++);
+
+  EntryHeader header{};
+  std::memcpy(header.magic, entryMagic, sizeof(entryMagic));
+  header.version = entryVersion;
+  header.keySize = keySize;
+  header.valueSize = valueSize;
+
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(static_cast<const char*>(key), keySize);
+    file.write(static_cast<const char*>(value), valueSize);
+    file.close();
+    if (!file)
+    {
+      std::error_code error;
+      std::filesystem::remove(temporary, error);
+      return;
+    }
+  }
+
+  // readers see either the previous entry or the complete new one
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error)
+  {
+    std::filesystem::remove(temporary, error);
+    return;
+  }
+  _stores++;
+
+  std::lock_guard lock(_mutex);
+  _size += entrySize;
+  if (_size > _budget)
+  {
+    trim();
+  }
+}
+
+std::filesystem::path PipelineCache::entryPath(
+  const void* key,
+  size_t keySize
+) const
+{
+  return _directory / (hex(hash(key, keySize)) + ".bin");
+}
+
+void PipelineCache::trim()
+{
+  struct File
+  {
+    std::filesystem::path path;
+    std::filesystem::file_time_type time;
+    uint64_t size;
+  };
+
+  auto now = std::filesystem::file_time_type::clock::now();
+  std::vector<File> files;
+  uint64_t size = 0;
+
+  std::error_code error;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(_directory, error))
+  {
+    std::error_code entryError;
+    if (!entry.is_regular_file(entryError))
+    {
+      continue;
+    }
+
+    File file{entry.path(), entry.last_write_time(entryError)};
+    file.size = entry.file_size(entryError);
+    if (entryError)
+    {
+      continue;
+    }
+
+    if (file.path.extension() != ".bin")
+    {
+      if (now - file.time > temporaryLifetime)
+      {
+        std::filesystem::remove(file.path, entryError);
+      }
+      continue;
+    }
+
+    size += file.size;
+    files.push_back(std::move(file));
+  }
+
+  // down to three quarters, so the next stores do not trim right away
+  if (size > _budget)
+  {
+    std::sort(
+      files.begin(),
+      files.end(),
+      [](const File& a, const File& b) { return a.time < b.time; }
+    );
+
+    for (const auto& file : files)
+    {
+      if (size <= _budget / 4 * 3)
+      {
+        break;
+      }
+
+      std::error_code removeError;
+      if (std::filesystem::remove(file.path, removeError))
+      {
+        size -= file.size;
+      }
+    }
+  }
+
+  _size = size;
+}
+}  // namespace graphics
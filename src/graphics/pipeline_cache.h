@@ -0,0 +1,91 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+namespace graphics
+{
+// On-disk store for the blobs Dawn caches, i.e. translated shaders and
+// compiled backend pipelines, so later launches skip both.
+//
+// Entries live in a directory per adapter, driver and Dawn version, one file
+// per key named after its hash. Files are written to a temporary name and
+// renamed into place, so a crash or a second instance never leaves a torn
+// entry behind. Once the directory outgrows its budget, the least recently
+// used entries are removed.
+//
+// Dawn calls into the cache from any thread, and for as long as the device
+// is alive, so the cache has to outlive it.
+class PipelineCache
+{
+ public:
+  static constexpr uint64_t defaultBudget = 64ull * 1024 * 1024;
+
+  PipelineCache(std::filesystem::path directory, uint64_t budget);
+  ~PipelineCache() = default;
+
+  PipelineCache(const PipelineCache&) = delete;
+  PipelineCache& operator=(const PipelineCache&) = delete;
+
+  // per user cache directory of the platform
+  static std::filesystem::path defaultDirectory();
+
+  // chains the cache into the descriptor of a device created from adapter,
+  // the descriptor must not outlive the cache
+  void attach(wgpu::DeviceDescriptor& descriptor, const wgpu::Adapter& adapter);
+
+  // hits, misses and size, on stderr
+  void report() const;
+
+ private:
+  static size_t loadData(
+    const void* key,
+    size_t keySize,
+    void* value,
+    size_t valueSize,
+    void* userdata
+  );
+  static void storeData(
+    const void* key,
+    size_t keySize,
+    const void* value,
+    size_t valueSize,
+    void* userdata
+  );
+
+  size_t load(const void* key, size_t keySize, void* value, size_t valueSize);
+  void store(
+    const void* key,
+    size_t keySize,
+    const void* value,
+    size_t valueSize
+  );
+
+  std::filesystem::path entryPath(const void* key, size_t keySize) const;
+
+  // removes least recently used entries until the directory fits again
+  void trim();
+
+ private:
+  std::filesystem::path _root;
+  std::filesystem::path _directory;
+  uint64_t _budget;
+
+  std::string _isolationKey;
+  wgpu::DawnCacheDeviceDescriptor _descriptor{};
+
+  mutable std::mutex _mutex;
+  uint64_t _size = 0;
+  bool _enabled = false;
+
+  std::atomic<uint32_t> _hits = 0;
+  std::atomic<uint32_t> _misses = 0;
+  std::atomic<uint32_t> _stores = 0;
+  std::atomic<uint32_t> _nextTemporary = 0;
+};
+}  // namespace graphics
@@ -0,0 +1,150 @@
+#include "render_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace graphics
+{
+// rows buffered before they are written, a few seconds of preview
+constexpr size_t rowBlockSize = 256;
+
+void FrameTimeHistogram::add(double seconds)
+{
+  if (_count == windowSize)
+  {
+    _buckets[bucket(_samples[_next])]--;
+  }
+  else
+  {
+    _count++;
+  }
+
+  _samples[_next] = seconds;
+  _buckets[bucket(seconds)]++;
+  _next = (_next + 1) % windowSize;
+}
+
+double FrameTimeHistogram::percentile(double p) const
+{
+  if (_count == 0)
+  {
+    return 0.0;
+  }
+
+  // nearest rank
+  size_t rank = (size_t)std::ceil(std::clamp(p, 0.0, 1.0) * (double)_count);
+  rank = std::max<size_t>(rank, 1);
+
+  size_t seen = 0;
+  for (size_t i = 0; i < bucketCount; i++)
+  {
+    seen += _buckets[i];
+    if (seen >= rank)
+    {
+      return (double)(i + 1) * bucketWidth;
+    }
+  }
+
+  // overflow bucket, report the longest frame of the window
+  double longest = 0.0;
+  for (size_t i = 0; i < _count; i++)
+  {
+    longest = std::max(longest, _samples[i]);
+  }
+  return longest;
+}
+
+void FrameTimeHistogram::clear()
+{
+  _next = 0;
+  _count = 0;
+  _buckets.fill(0);
+}
+
+size_t FrameTimeHistogram::bucket(double seconds)
+{
+  double index = std::max(seconds, 0.0) / bucketWidth;
+  return index < (double)bucketCount ? (size_t)index : bucketCount;
+}
+
+void RenderStats::endFrame(uint64_t frame, double cpuSeconds)
+{
+  _cpuTimes.add(cpuSeconds);
+  if (_gpuSeconds >= 0.0)
+  {
+    _gpuTimes.add(_gpuSeconds);
+  }
+
+  if (_file.is_open())
+  {
+    _rows.push_back({frame, cpuSeconds, _gpuSeconds, _current});
+    if (_rows.size() == rowBlockSize)
+    {
+      writeRows();
+    }
+  }
+
+  _last = _current;
+  _lastCpuSeconds = cpuSeconds;
+  _lastGpuSeconds = _gpuSeconds;
+  _current = {};
+  _gpuSeconds = -1.0;
+  _frameCount++;
+}
+
+bool RenderStats::record(const std::filesystem::path& path)
+{
+  _file.open(path);
+  if (!_file.is_open())
+  {
+    std::cerr << "[Stats] Could not open " << path.string() << std::endl;
+    return false;
+  }
+
+  _path = path;
+  _writtenRows = 0;
+  _rows.clear();
+  _rows.reserve(rowBlockSize);
+
+  _file << "frame,cpu_ms,gpu_ms,draw_calls,instances,bind_group_switches,"
+           "pipeline_switches,upload_bytes\n";
+  _file << std::fixed << std::setprecision(4);
+  return true;
+}
+
+bool RenderStats::finishRecording()
+{
+  if (!_file.is_open())
+  {
+    return false;
+  }
+
+  writeRows();
+  _file.close();
+
+  std::cerr << "[Stats] Wrote " << _writtenRows << " frames to "
+            << _path.string() << std::endl;
+  return !_file.fail();
+}
+
+void RenderStats::writeRows()
+{
+  for (const auto& row : _rows)
+  {
+    _file << row.frame << "," << row.cpuSeconds * 1e3 << ",";
+    if (row.gpuSeconds >= 0.0)
+    {
+      _file << row.gpuSeconds * 1e3;
+    }
+    _file << "," << row.counters.drawCalls << "," << row.counters.instances
+          << "," << row.counters.bindGroupSwitches << ","
+          << row.counters.pipelineSwitches << ","
+          << row.counters.uploadBytes << "\n";
+  }
+  _writtenRows += _rows.size();
+  _rows.clear();
+}
+}  // namespace graphics
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace graphics
+{
+struct RenderCounters
+{
+  uint32_t drawCalls = 0;
+  uint32_t instances = 0;
+  uint32_t bindGroupSwitches = 0;
+  uint32_t pipelineSwitches = 0;
+  uint64_t uploadBytes = 0;
+};
+
+// Durations of the latest frames in fixed 0.1 ms buckets up to 100 ms,
+// longer frames land in an overflow bucket. Adding a frame removes the
+// oldest one from the window, so percentiles follow recent frames and cost
+// a scan over the buckets without sorting or allocating.
+class FrameTimeHistogram
+{
+ public:
+  static constexpr size_t windowSize = 600;
+  static constexpr size_t bucketCount = 1000;
+  static constexpr double bucketWidth = 1e-4;
+
+  void add(double seconds);
+
+  // upper bound of the bucket containing the percentile, p in [0, 1]
+  double percentile(double p) const;
+
+  size_t count() const
+  {
+    return _count;
+  }
+
+  void clear();
+
+ private:
+  static size_t bucket(double seconds);
+
+ private:
+  std::array<double, windowSize> _samples{};
+  size_t _next = 0;
+  size_t _count = 0;
+
+  std::array<uint32_t, bucketCount + 1> _buckets{};
+};
+
+// Per-frame counters of the renderer and rolling CPU and GPU frame times.
+//
+// The renderer, and the classes drawing and uploading through it, add to
+// the counters of the current frame; the front-end closes a frame with
+// endFrame once it has been presented or written. GPU times are the sum of
+// the timed passes and arrive a few frames late, so they are attributed to
+// the frame in which they were read back.
+class RenderStats
+{
+ public:
+  void draw(uint32_t instances)
+  {
+    _current.drawCalls++;
+    _current.instances += instances;
+  }
+
+  void upload(uint64_t bytes)
+  {
+    _current.uploadBytes += bytes;
+  }
+
+  void bindGroupSwitch()
+  {
+    _current.bindGroupSwitches++;
+  }
+
+  void pipelineSwitch()
+  {
+    _current.pipelineSwitches++;
+  }
+
+  // adds up the passes read back during a frame, e.g. of several flushes
+  void gpuTime(double seconds)
+  {
+    _gpuSeconds = std::max(_gpuSeconds, 0.0) + seconds;
+  }
+
+  void endFrame(uint64_t frame, double cpuSeconds);
+
+  // counters of the frame being recorded and of the last finished frame
+  const RenderCounters& current() const
+  {
+    return _current;
+  }
+
+  const RenderCounters& last() const
+  {
+    return _last;
+  }
+
+  double lastCpuTime() const
+  {
+    return _lastCpuSeconds;
+  }
+
+  // negative if no GPU time was read back during the last frame
+  double lastGpuTime() const
+  {
+    return _lastGpuSeconds;
+  }
+
+  const FrameTimeHistogram& cpuTimes() const
+  {
+    return _cpuTimes;
+  }
+
+  const FrameTimeHistogram& gpuTimes() const
+  {
+    return _gpuTimes;
+  }
+
+  uint64_t frameCount() const
+  {
+    return _frameCount;
+  }
+
+  // streams a row per finished frame to a CSV file, off by default. Rows
+  // are buffered and written in blocks, so recording does not allocate.
+  bool record(const std::filesystem::path& path);
+
+  // writes the buffered rows and closes the file
+  bool finishRecording();
+
+ private:
+  struct Row
+  {
+    uint64_t frame;
+    double cpuSeconds;
+    double gpuSeconds;
+    RenderCounters counters;
+  };
+
+  void writeRows();
+
+ private:
+  RenderCounters _current;
+  RenderCounters _last;
+
+  // negative until the first readback of the frame
+  double _gpuSeconds = -1.0;
+  double _lastCpuSeconds = 0.0;
+  double _lastGpuSeconds = -1.0;
+
+  FrameTimeHistogram _cpuTimes;
+  FrameTimeHistogram _gpuTimes;
+  uint64_t _frameCount = 0;
+
+  std::ofstream _file;
+  std::filesystem::path _path;
+  std::vector<Row> _rows;
+  uint64_t _writtenRows = 0;
+};
+}  // namespace graphics
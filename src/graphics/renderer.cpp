@@ -1,8 +1,15 @@
 #include "renderer.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "graphics/text_morph.h"
+#include "graphics/text_stroke.h"
+#include "util/profiler.h"
 
 namespace graphics
 {
@@ -13,21 +20,38 @@ Renderer::Renderer(
   const wgpu::Queue& queue,
   wgpu::TextureFormat format
 )
-  : _device(device), _queue(queue)
+  : _gpuTimer(device), _device(device), _queue(queue)
 {
   createSamplers();
   createTextBuffers();
   createTextPipeline(format);
+  createStrokePipeline(format);
+}
+
+Renderer::~Renderer()
+{
+  // the creation callbacks write into the renderer
+  for (auto* target : {&_textPipeline, &_strokePipeline})
+  {
+    while (!target->done.load(std::memory_order_acquire))
+    {
+      _device.Tick();
+      std::this_thread::yield();
+    }
+  }
 }
 
 void Renderer::drawText(Text& text, const Camera& camera)
 {
+  TANIM_PROFILE_ZONE("Renderer::drawText");
+
   _queue.WriteBuffer(
     _textUniformBuffer,
     0,
     &camera.viewProjection(),
     sizeof(glm::mat4)
   );
+  _stats.upload(sizeof(glm::mat4));
 
   for (auto& character : text._characters)
   {
@@ -35,14 +59,143 @@ void Renderer::drawText(Text& text, const Camera& camera)
   }
 }
 
-void Renderer::flush(const wgpu::TextureView& view)
+void Renderer::drawFrame(const FrameData& frame)
+{
+  TANIM_PROFILE_ZONE("Renderer::drawFrame");
+
+  TextUniformsGPU uniforms{};
+  uniforms.viewProjection = frame.viewProjection;
+  uniforms.time = (float)frame.time;
+  _queue.WriteBuffer(_textUniformBuffer, 0, &uniforms, sizeof(uniforms));
+  _stats.upload(sizeof(uniforms));
+
+  _textCharacterData.insert(
+    _textCharacterData.end(),
+    frame.characters.begin(),
+    frame.characters.end()
+  );
+
+  for (const auto& draw : frame.morphs)
+  {
+    draw.morph->update(draw.progress);
+    draw.morph->draw(*this);
+  }
+
+  for (const auto& draw : frame.strokes)
+  {
+    draw.stroke->update(draw.transform, draw.color, draw.progress);
+    draw.stroke->draw(*this);
+  }
+}
+
+void Renderer::drawInstances(const wgpu::BindGroup& bindGroup, uint32_t count)
+{
+  if (count > 0)
+  {
+    _instanceDraws.push_back({bindGroup, count});
+  }
+}
+
+wgpu::BindGroup Renderer::createTextBindGroup(const wgpu::Buffer& characters)
+{
+  return createTextBindGroup(characters, _textUniformBuffer);
+}
+
+wgpu::BindGroup Renderer::createTextBindGroup(
+  const wgpu::Buffer& characters,
+  const wgpu::Buffer& uniforms
+)
+{
+  std::array<wgpu::BindGroupEntry, 4> bindGroupEntries{};
+  bindGroupEntries[0].buffer = characters;
+  bindGroupEntries[0].binding = 0;
+
+  bindGroupEntries[1].buffer = uniforms;
+  bindGroupEntries[1].binding = 1;
+
+  bindGroupEntries[2].textureView = _textAtlasView;
+  bindGroupEntries[2].binding = 2;
+
+  bindGroupEntries[3].sampler = _linearSampler;
+  bindGroupEntries[3].binding = 3;
+
+  wgpu::BindGroupDescriptor bindGroupDescriptor{};
+  bindGroupDescriptor.label = "Renderer Text Bind Group";
+  bindGroupDescriptor.entryCount = bindGroupEntries.size();
+  bindGroupDescriptor.entries = bindGroupEntries.data();
+  bindGroupDescriptor.layout = _textBindGroupLayout;
+  return _device.CreateBindGroup(&bindGroupDescriptor);
+}
+
+void Renderer::drawStrokes(
+  const wgpu::BindGroup& bindGroup,
+  uint32_t segmentCount
+)
+{
+  if (segmentCount > 0)
+  {
+    _strokeDraws.push_back({bindGroup, segmentCount});
+  }
+}
+
+wgpu::BindGroup Renderer::createStrokeBindGroup(
+  const wgpu::Buffer& segments,
+  const wgpu::Buffer& uniforms
+)
+{
+  std::array<wgpu::BindGroupEntry, 3> bindGroupEntries{};
+  bindGroupEntries[0].buffer = segments;
+  bindGroupEntries[0].binding = 0;
+
+  bindGroupEntries[1].buffer = _textUniformBuffer;
+  bindGroupEntries[1].binding = 1;
+
+  bindGroupEntries[2].buffer = uniforms;
+  bindGroupEntries[2].binding = 2;
+
+  wgpu::BindGroupDescriptor bindGroupDescriptor{};
+  bindGroupDescriptor.label = "Renderer Stroke Bind Group";
+  bindGroupDescriptor.entryCount = bindGroupEntries.size();
+  bindGroupDescriptor.entries = bindGroupEntries.data();
+  bindGroupDescriptor.layout = _strokeBindGroupLayout;
+  return _device.CreateBindGroup(&bindGroupDescriptor);
+}
+
+void Renderer::flush(const wgpu::TextureView& view, wgpu::LoadOp loadOp)
 {
+  TANIM_PROFILE_ZONE("Renderer::flush");
+
+  waitForPipelines();
+
+  // grows to the largest frame seen, later frames reuse buffer and bind group
+  if (_textCharacterData.size() > _textCharacterCapacity)
+  {
+    createTextCharacterBuffer(
+      std::max(_textCharacterData.size(), _textCharacterCapacity * 2)
+    );
+    _textBindGroup = createTextBindGroup(_textCharacterBuffer);
+  }
+
   _queue.WriteBuffer(
     _textCharacterBuffer,
     0,
     _textCharacterData.data(),
     _textCharacterData.size() * sizeof(TextCharacterGPU)
   );
+  _stats.upload(_textCharacterData.size() * sizeof(TextCharacterGPU));
+
+  // includes the compute passes timed since the last flush
+  _gpuTimer.begin();
+  if (!_gpuTimer.timings().empty())
+  {
+    uint64_t nanoseconds = 0;
+    for (const auto& timing : _gpuTimer.timings())
+    {
+      nanoseconds += timing.nanoseconds;
+    }
+    _stats.gpuTime((double)nanoseconds * 1e-9);
+    _gpuTimer.clearTimings();
+  }
 
   wgpu::CommandEncoderDescriptor encoderDescriptor{};
   encoderDescriptor.label = "Renderer Command Encoder";
@@ -50,7 +203,7 @@ void Renderer::flush(const wgpu::TextureView& view)
 
   wgpu::RenderPassColorAttachment colorAttachment{};
   colorAttachment.view = view;
-  colorAttachment.loadOp = wgpu::LoadOp::Clear;
+  colorAttachment.loadOp = loadOp;
   colorAttachment.storeOp = wgpu::StoreOp::Store;
   colorAttachment.clearValue = {0.1, 0.1, 0.1, 1.0};
   colorAttachment.depthSlice = wgpu::kDepthSliceUndefined;
@@ -59,16 +212,69 @@ void Renderer::flush(const wgpu::TextureView& view)
   renderPassDescriptor.label = "Renderer Render Pass";
   renderPassDescriptor.colorAttachmentCount = 1;
   renderPassDescriptor.colorAttachments = &colorAttachment;
+  renderPassDescriptor.timestampWrites =
+    _gpuTimer.renderPass("Renderer Render Pass");
 
   auto renderPass = encoder.BeginRenderPass(&renderPassDescriptor);
   flushText(renderPass);
+  flushStrokes(renderPass);
   renderPass.End();
 
+  _gpuTimer.resolve(encoder);
+
   wgpu::CommandBufferDescriptor commandDescriptor{};
   commandDescriptor.label = "Renderer Command Buffer";
   auto command = encoder.Finish(&commandDescriptor);
 
   _queue.Submit(1, &command);
+  _gpuTimer.submitted();
+
+  nextFrame();
+}
+
+void Renderer::nextFrame()
+{
+  size_t characters = _textCharacterData.capacity();
+  size_t instanceDraws = _instanceDraws.capacity();
+  size_t strokeDraws = _strokeDraws.capacity();
+
+  // the lists were emptied by the passes, their memory is given up with the
+  // arena frame it was bumped from
+  _frameArena.nextFrame();
+  _textCharacterData = std::pmr::vector<TextCharacterGPU>(&_frameArena);
+  _instanceDraws = std::pmr::vector<InstanceDraw>(&_frameArena);
+  _strokeDraws = std::pmr::vector<InstanceDraw>(&_frameArena);
+
+  // as large as last frame, so recording the next one only bumps once
+  _textCharacterData.reserve(characters);
+  _instanceDraws.reserve(instanceDraws);
+  _strokeDraws.reserve(strokeDraws);
+}
+
+void Renderer::waitForPipelines()
+{
+  if (_pipelinesReady)
+  {
+    return;
+  }
+
+  TANIM_PROFILE_ZONE("Renderer::waitForPipelines");
+
+  for (auto* target : {&_textPipeline, &_strokePipeline})
+  {
+    // ticking the device lets the completed creation call back
+    while (!target->done.load(std::memory_order_acquire))
+    {
+      _device.Tick();
+      std::this_thread::yield();
+    }
+
+    if (!target->pipeline)
+    {
+      throw std::runtime_error("Could not create the renderer pipelines");
+    }
+  }
+  _pipelinesReady = true;
 }
 
 const graphics::Font& Renderer::font(const std::filesystem::path& path)
@@ -78,8 +284,63 @@ const graphics::Font& Renderer::font(const std::filesystem::path& path)
     return _fonts.at(path);
   }
 
-  _fonts.insert({path, graphics::Font(_device, _queue, path)});
-  return _fonts.at(path);
+  return addFont(path, Font::decode(path));
+}
+
+const graphics::Font& Renderer::atlasFont()
+{
+  if (!_atlasFont)
+  {
+    font(defaultFont);
+  }
+  return *_atlasFont;
+}
+
+const graphics::Font& Renderer::addFont(
+  const std::filesystem::path& path,
+  FontData data
+)
+{
+  auto it = _fonts.find(path);
+  if (it != _fonts.end())
+  {
+    return it->second;
+  }
+
+  uint64_t atlasBytes = data.pixels.size();
+  auto& font =
+    _fonts.emplace(path, Font(_device, _queue, std::move(data))).first->second;
+  _stats.upload(atlasBytes);
+
+  // the text pipeline samples a single atlas
+  if (_fonts.size() == 1)
+  {
+    _atlasFont = &font;
+    _textAtlasView = font.atlasView();
+    _textBindGroup = createTextBindGroup(_textCharacterBuffer);
+  }
+  return font;
+}
+
+GlyphOutlines& Renderer::outlines(
+  const std::filesystem::path& path,
+  float emSize
+)
+{
+  auto key = std::make_pair(path, emSize);
+  auto it = _outlines.find(key);
+  if (it != _outlines.end())
+  {
+    return it->second;
+  }
+
+  return _outlines
+    .emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple(std::move(key)),
+      std::forward_as_tuple(path, emSize)
+    )
+    .first->second;
 }
 
 void Renderer::createSamplers()
@@ -105,22 +366,38 @@ void Renderer::createSamplers()
 
 void Renderer::createTextBuffers()
 {
-  _textCharacterData.reserve(textCharacterCount);
-
-  wgpu::BufferDescriptor textCharacterBufferDescriptor{};
-  textCharacterBufferDescriptor.label = "Renderer Text Character Buffer";
-  textCharacterBufferDescriptor.size =
-    textCharacterCount * sizeof(TextCharacterGPU);
-  textCharacterBufferDescriptor.usage =
-    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
-  _textCharacterBuffer = _device.CreateBuffer(&textCharacterBufferDescriptor);
+  createTextCharacterBuffer(textCharacterCount);
 
   wgpu::BufferDescriptor textUniformBufferDescriptor{};
   textUniformBufferDescriptor.label = "Renderer Text Uniform Buffer";
-  textUniformBufferDescriptor.size = sizeof(glm::mat4);
+  textUniformBufferDescriptor.size = sizeof(TextUniformsGPU);
   textUniformBufferDescriptor.usage =
     wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
   _textUniformBuffer = _device.CreateBuffer(&textUniformBufferDescriptor);
+
+  // bound until the first font is loaded, textures start out zeroed
+  wgpu::TextureDescriptor atlasDescriptor{};
+  atlasDescriptor.label = "Renderer Blank Atlas Texture";
+  atlasDescriptor.dimension = wgpu::TextureDimension::e2D;
+  atlasDescriptor.size = {1, 1, 1};
+  atlasDescriptor.mipLevelCount = 1;
+  atlasDescriptor.sampleCount = 1;
+  atlasDescriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+  atlasDescriptor.usage = wgpu::TextureUsage::TextureBinding;
+  _textAtlasView = _device.CreateTexture(&atlasDescriptor).CreateView();
+}
+
+void Renderer::createTextCharacterBuffer(size_t capacity)
+{
+  _textCharacterData.reserve(capacity);
+  _textCharacterCapacity = capacity;
+
+  wgpu::BufferDescriptor textCharacterBufferDescriptor{};
+  textCharacterBufferDescriptor.label = "Renderer Text Character Buffer";
+  textCharacterBufferDescriptor.size = capacity * sizeof(TextCharacterGPU);
+  textCharacterBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+  _textCharacterBuffer = _device.CreateBuffer(&textCharacterBufferDescriptor);
 }
 
 void Renderer::createTextPipeline(wgpu::TextureFormat format)
@@ -150,31 +427,9 @@ void Renderer::createTextPipeline(wgpu::TextureFormat format)
   bindGroupLayoutDescriptor.entryCount =
     (uint32_t)bindGroupLayoutEntries.size();
   bindGroupLayoutDescriptor.entries = bindGroupLayoutEntries.data();
-  auto bindGroupLayout =
+  _textBindGroupLayout =
     _device.CreateBindGroupLayout(&bindGroupLayoutDescriptor);
-
-  std::array<wgpu::BindGroupEntry, 4> bindGroupEntries{};
-  bindGroupEntries[0].buffer = _textCharacterBuffer;
-  bindGroupEntries[0].binding = 0;
-
-  bindGroupEntries[1].buffer = _textUniformBuffer;
-  bindGroupEntries[1].binding = 1;
-
-  // temporary
-  auto& font = this->font("assets/fonts/ARIALBD.TTF-msdf");
-
-  bindGroupEntries[2].textureView = font.atlasView();
-  bindGroupEntries[2].binding = 2;
-
-  bindGroupEntries[3].sampler = _linearSampler;
-  bindGroupEntries[3].binding = 3;
-
-  wgpu::BindGroupDescriptor bindGroupDescriptor{};
-  bindGroupDescriptor.label = "Renderer Text Bind Group";
-  bindGroupDescriptor.entryCount = bindGroupEntries.size();
-  bindGroupDescriptor.entries = bindGroupEntries.data();
-  bindGroupDescriptor.layout = bindGroupLayout;
-  _textBindGroup = _device.CreateBindGroup(&bindGroupDescriptor);
+  _textBindGroup = createTextBindGroup(_textCharacterBuffer);
 
   const char* shaderCode = R"(
     const positions = array<vec2f, 4>(
@@ -192,29 +447,85 @@ void Renderer::createTextPipeline(wgpu::TextureFormat format)
     struct VertexOutput {
       @builtin(position) position: vec4f,
       @location(0) uv: vec2f,
-      @location(1) color: vec3f,
+      @location(1) color: vec4f,
     };
 
     struct TextCharacter {
       transform: mat4x4<f32>,
       bounds: vec4f,
-      color: vec3f,
+      color: vec4f,
       size: vec2f,
       position: vec2f,
+      effect: vec4f,
+      effectType: u32,
+      effectEasing: u32,
+      index: u32,
+    };
+
+    struct Uniforms {
+      viewProjection: mat4x4<f32>,
+      time: f32,
+    };
+
+    struct GlyphState {
+      offset: vec2f,
+      scale: f32,
+      alpha: f32,
     };
 
     @group(0) @binding(0) var<storage, read> characters: array<TextCharacter>;
-    @group(0) @binding(1) var<uniform> viewProjection: mat4x4<f32>;
+    @group(0) @binding(1) var<uniform> uniforms: Uniforms;
     @group(0) @binding(2) var fontTexture: texture_2d<f32>;
     @group(0) @binding(3) var fontSampler: sampler;
 
+    // same curves as animation::ease
+    fn ease(easing: u32, t: f32) -> f32 {
+      switch easing {
+        case 1u: { return select(0.0, 1.0, t >= 1.0); }
+        case 2u: { return t * t * t; }
+        case 3u: { let u = 1.0 - t; return 1.0 - u * u * u; }
+        case 4u: { return t * t * (3.0 - 2.0 * t); }
+        default: { return t; }
+      }
+    }
+
+    // graphics::GlyphEffectType
+    fn glyphEffect(character: TextCharacter) -> GlyphState {
+      var state = GlyphState(vec2f(0.0), 1.0, 1.0);
+
+      let duration = max(character.effect.z, 1e-5);
+      let index = f32(character.index);
+      let start = character.effect.x + index * character.effect.y;
+      let elapsed = uniforms.time - start;
+      let progress = ease(
+        character.effectEasing,
+        clamp(elapsed / duration, 0.0, 1.0)
+      );
+
+      switch character.effectType {
+        case 1u: { state.alpha = select(0.0, 1.0, elapsed >= 0.0); }
+        case 2u: { state.alpha = progress; }
+        case 3u: { state.scale = progress; }
+        case 4u: {
+          let wave = sin(max(elapsed, 0.0) / duration * 6.28318530718);
+          state.offset.y = character.effect.w * progress * wave;
+        }
+        default: {}
+      }
+      return state;
+    }
+
     @vertex 
     fn vsMain(in: VertexInput) -> VertexOutput {
       let character = characters[in.instanceIndex];
+      let effect = glyphEffect(character);
 
+      // effects scale each glyph around its own center
+      let center = vec2f(0.5, -0.5) * character.size;
       var vertexPosition = positions[in.vertexIndex];
       vertexPosition *= character.size;
-      vertexPosition += character.position;
+      vertexPosition = center + (vertexPosition - center) * effect.scale;
+      vertexPosition += character.position + effect.offset;
 
       let uvs = array<vec2f, 4>(
         character.bounds.xz,
@@ -226,9 +537,9 @@ void Renderer::createTextPipeline(wgpu::TextureFormat format)
       let uv = uvs[in.vertexIndex];
 
       var out: VertexOutput;
-      out.position = viewProjection * character.transform * vec4f(vertexPosition, 0.0, 1.0);
+      out.position = uniforms.viewProjection * character.transform * vec4f(vertexPosition, 0.0, 1.0);
       out.uv = uv;
-      out.color = character.color;
+      out.color = vec4f(character.color.rgb, character.color.a * effect.alpha);
       return out;
     }
 
@@ -253,7 +564,7 @@ void Renderer::createTextPipeline(wgpu::TextureFormat format)
 
       let alpha = smoothstep(-edgeWidth, edgeWidth, pxDist);
 
-      return vec4f(in.color, alpha);
+      return vec4f(in.color.rgb, alpha * in.color.a);
     }
 )";
 
@@ -289,7 +600,7 @@ void Renderer::createTextPipeline(wgpu::TextureFormat format)
   wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{};
   pipelineLayoutDescriptor.label = "Renderer Text Pipeline Layout";
   pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
-  pipelineLayoutDescriptor.bindGroupLayouts = &bindGroupLayout;
+  pipelineLayoutDescriptor.bindGroupLayouts = &_textBindGroupLayout;
   auto pipelineLayout = _device.CreatePipelineLayout(&pipelineLayoutDescriptor);
 
   wgpu::RenderPipelineDescriptor pipelineDescriptor{};
@@ -299,15 +610,219 @@ void Renderer::createTextPipeline(wgpu::TextureFormat format)
   pipelineDescriptor.primitive.topology =
     wgpu::PrimitiveTopology::TriangleStrip;
   pipelineDescriptor.layout = pipelineLayout;
-  _textPipeline = _device.CreateRenderPipeline(&pipelineDescriptor);
+  createPipelineAsync(pipelineDescriptor, _textPipeline);
 }
 
 void Renderer::flushText(const wgpu::RenderPassEncoder& renderPass)
 {
-  renderPass.SetPipeline(_textPipeline);
-  renderPass.SetBindGroup(0, _textBindGroup);
-  renderPass.Draw(4, (uint32_t)_textCharacterData.size(), 0, 0);
+  // e.g. the overlay pass, which only draws instances
+  if (_textCharacterData.empty() && _instanceDraws.empty())
+  {
+    return;
+  }
+
+  renderPass.SetPipeline(_textPipeline.pipeline);
+  _stats.pipelineSwitch();
+
+  if (!_textCharacterData.empty())
+  {
+    renderPass.SetBindGroup(0, _textBindGroup);
+    renderPass.Draw(4, (uint32_t)_textCharacterData.size(), 0, 0);
+    _stats.bindGroupSwitch();
+    _stats.draw((uint32_t)_textCharacterData.size());
+  }
+
+  for (const auto& draw : _instanceDraws)
+  {
+    renderPass.SetBindGroup(0, draw.bindGroup);
+    renderPass.Draw(4, draw.count, 0, 0);
+    _stats.bindGroupSwitch();
+    _stats.draw(draw.count);
+  }
 
   _textCharacterData.clear();
+  _instanceDraws.clear();
+}
+
+void Renderer::createStrokePipeline(wgpu::TextureFormat format)
+{
+  std::array<wgpu::BindGroupLayoutEntry, 3> bindGroupLayoutEntries{};
+  bindGroupLayoutEntries[0].binding = 0;
+  bindGroupLayoutEntries[0].visibility = wgpu::ShaderStage::Vertex;
+  bindGroupLayoutEntries[0].buffer.type =
+    wgpu::BufferBindingType::ReadOnlyStorage;
+
+  bindGroupLayoutEntries[1].binding = 1;
+  bindGroupLayoutEntries[1].visibility = wgpu::ShaderStage::Vertex;
+  bindGroupLayoutEntries[1].buffer.type = wgpu::BufferBindingType::Uniform;
+
+  bindGroupLayoutEntries[2].binding = 2;
+  bindGroupLayoutEntries[2].visibility =
+    wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment;
+  bindGroupLayoutEntries[2].buffer.type = wgpu::BufferBindingType::Uniform;
+
+  wgpu::BindGroupLayoutDescriptor bindGroupLayoutDescriptor{};
+  bindGroupLayoutDescriptor.label = "Renderer Stroke Bind Group Layout";
+  bindGroupLayoutDescriptor.entryCount =
+    (uint32_t)bindGroupLayoutEntries.size();
+  bindGroupLayoutDescriptor.entries = bindGroupLayoutEntries.data();
+  _strokeBindGroupLayout =
+    _device.CreateBindGroupLayout(&bindGroupLayoutDescriptor);
+
+  const char* shaderCode = R"(
+    struct Segment {
+      start: vec2f,
+      end: vec2f,
+      lengths: vec2f,
+    };
+
+    struct Uniforms {
+      viewProjection: mat4x4<f32>,
+      time: f32,
+    };
+
+    struct Stroke {
+      transform: mat4x4<f32>,
+      color: vec4f,
+      reveal: f32,
+      thickness: f32,
+    };
+
+    @group(0) @binding(0) var<storage, read> segments: array<Segment>;
+    @group(0) @binding(1) var<uniform> uniforms: Uniforms;
+    @group(0) @binding(2) var<uniform> stroke: Stroke;
+
+    @vertex
+    fn vsMain(
+      @builtin(vertex_index) vertexIndex: u32,
+      @builtin(instance_index) instanceIndex: u32
+    ) -> @builtin(position) vec4f {
+      let segment = segments[instanceIndex];
+      if (segment.lengths.x >= stroke.reveal) {
+        // not written yet, collapse the quad outside of the clip volume
+        return vec4f(2.0, 2.0, 2.0, 1.0);
+      }
+
+      // cut the segment which is currently being written
+      let span = max(segment.lengths.y - segment.lengths.x, 1e-6);
+      let t = clamp((stroke.reveal - segment.lengths.x) / span, 0.0, 1.0);
+      let end = mix(segment.start, segment.end, t);
+
+      let delta = end - segment.start;
+      let len = length(delta);
+      let direction = select(vec2f(1.0, 0.0), delta / len, len > 1e-6);
+
+      // extend by half the thickness so consecutive segments overlap
+      let halfThickness = stroke.thickness * 0.5;
+      let along = direction * halfThickness;
+      let across = vec2f(-direction.y, direction.x) * halfThickness;
+      let corners = array<vec2f, 4>(
+        segment.start - along - across,
+        segment.start - along + across,
+        end + along - across,
+        end + along + across
+      );
+
+      let position = vec4f(corners[vertexIndex], 0.0, 1.0);
+      return uniforms.viewProjection * stroke.transform * position;
+    }
+
+    @fragment
+    fn fsMain() -> @location(0) vec4f {
+      return stroke.color;
+    }
+)";
+
+  wgpu::ShaderModuleWGSLDescriptor wgslDescriptor{};
+  wgslDescriptor.code = shaderCode;
+  wgslDescriptor.sType = wgpu::SType::ShaderSourceWGSL;
+
+  wgpu::ShaderModuleDescriptor shaderModuleDescriptor{};
+  shaderModuleDescriptor.label = "Renderer Stroke Shader Module";
+  shaderModuleDescriptor.nextInChain = &wgslDescriptor;
+
+  wgpu::ShaderModule shaderModule =
+    _device.CreateShaderModule(&shaderModuleDescriptor);
+
+  wgpu::BlendState blendState{};
+  blendState.alpha.srcFactor = wgpu::BlendFactor::One;
+  blendState.alpha.dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha;
+  blendState.alpha.operation = wgpu::BlendOperation::Add;
+  blendState.color.srcFactor = wgpu::BlendFactor::SrcAlpha;
+  blendState.color.dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha;
+  blendState.color.operation = wgpu::BlendOperation::Add;
+
+  wgpu::ColorTargetState colorTargetState{};
+  colorTargetState.format = format;
+  colorTargetState.blend = &blendState;
+  colorTargetState.writeMask = wgpu::ColorWriteMask::All;
+
+  wgpu::FragmentState fragmentState{};
+  fragmentState.module = shaderModule;
+  fragmentState.targetCount = 1;
+  fragmentState.targets = &colorTargetState;
+
+  wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{};
+  pipelineLayoutDescriptor.label = "Renderer Stroke Pipeline Layout";
+  pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
+  pipelineLayoutDescriptor.bindGroupLayouts = &_strokeBindGroupLayout;
+  auto pipelineLayout = _device.CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+  wgpu::RenderPipelineDescriptor pipelineDescriptor{};
+  pipelineDescriptor.label = "Renderer Stroke Pipeline";
+  pipelineDescriptor.fragment = &fragmentState;
+  pipelineDescriptor.vertex.module = shaderModule;
+  pipelineDescriptor.primitive.topology =
+    wgpu::PrimitiveTopology::TriangleStrip;
+  pipelineDescriptor.layout = pipelineLayout;
+  createPipelineAsync(pipelineDescriptor, _strokePipeline);
+}
+
+void Renderer::createPipelineAsync(
+  const wgpu::RenderPipelineDescriptor& descriptor,
+  AsyncPipeline& target
+)
+{
+  // may complete on a worker thread, the pipeline is only read after done
+  _device.CreateRenderPipelineAsync(
+    &descriptor,
+    wgpu::CallbackMode::AllowSpontaneous,
+    [](
+      wgpu::CreatePipelineAsyncStatus status,
+      wgpu::RenderPipeline pipeline,
+      wgpu::StringView message,
+      AsyncPipeline* target
+    )
+    {
+      if (status != wgpu::CreatePipelineAsyncStatus::Success)
+      {
+        std::cerr << "[WebGPU] Failed to create pipeline: " << message
+                  << std::endl;
+      }
+      target->pipeline = std::move(pipeline);
+      target->done.store(true, std::memory_order_release);
+    },
+    &target
+  );
+}
+
+void Renderer::flushStrokes(const wgpu::RenderPassEncoder& renderPass)
+{
+  if (_strokeDraws.empty())
+  {
+    return;
+  }
+
+  renderPass.SetPipeline(_strokePipeline.pipeline);
+  _stats.pipelineSwitch();
+  for (const auto& draw : _strokeDraws)
+  {
+    renderPass.SetBindGroup(0, draw.bindGroup);
+    renderPass.Draw(4, draw.count, 0, 0);
+    _stats.bindGroupSwitch();
+    _stats.draw(draw.count);
+  }
+
+  _strokeDraws.clear();
 }
 }  // namespace graphics
@@ -3,13 +3,21 @@
 #include <webgpu/webgpu_cpp.h>
 
 #include <array>
+#include <atomic>
 #include <filesystem>
 #include <glm/glm.hpp>
+#include <map>
+#include <memory_resource>
 
 #include "graphics/camera.h"
 #include "graphics/font.h"
+#include "graphics/frame_data.h"
+#include "graphics/glyph_outlines.h"
+#include "graphics/gpu_timer.h"
 #include "graphics/gpu_types.h"
+#include "graphics/render_stats.h"
 #include "graphics/text.h"
+#include "util/frame_arena.h"
 
 namespace graphics
 {
@@ -21,11 +29,49 @@ class Renderer
     const wgpu::Queue& queue,
     wgpu::TextureFormat format
   );
-  ~Renderer() = default;
+  ~Renderer();
 
   void drawText(Text& text, const Camera& camera);
 
-  void flush(const wgpu::TextureView& view);
+  void drawFrame(const FrameData& frame);
+
+  // draws count characters straight from a GPU buffer laid out as
+  // TextCharacterGPU, e.g. written by a compute pass
+  void drawInstances(const wgpu::BindGroup& bindGroup, uint32_t count);
+
+  // text bind groups sample the atlas of the first font loaded, those created
+  // before any font was loaded sample a blank one
+  wgpu::BindGroup createTextBindGroup(const wgpu::Buffer& characters);
+
+  // with a view projection of its own, laid out as TextUniformsGPU
+  wgpu::BindGroup createTextBindGroup(
+    const wgpu::Buffer& characters,
+    const wgpu::Buffer& uniforms
+  );
+
+  // draws outline segments laid out as StrokeSegmentGPU
+  void drawStrokes(const wgpu::BindGroup& bindGroup, uint32_t segmentCount);
+
+  wgpu::BindGroup createStrokeBindGroup(
+    const wgpu::Buffer& segments,
+    const wgpu::Buffer& uniforms
+  );
+
+  // Load draws on top of the contents of the view
+  void flush(
+    const wgpu::TextureView& view,
+    wgpu::LoadOp loadOp = wgpu::LoadOp::Clear
+  );
+
+  const wgpu::Device& device() const
+  {
+    return _device;
+  }
+
+  const wgpu::Queue& queue() const
+  {
+    return _queue;
+  }
 
   const wgpu::Sampler& linearSampler() const
   {
@@ -37,30 +83,107 @@ class Renderer
     return _nearestSampler;
   }
 
+  // only valid once waitForPipelines returned
   const wgpu::RenderPipeline& textPipeline() const
   {
-    return _textPipeline;
+    return _textPipeline.pipeline;
+  }
+
+  // pipelines are compiled in the background from construction on, the
+  // first flush waits for them
+  void waitForPipelines();
+
+  // also times the compute passes recorded outside the renderer, the next
+  // flush adds them to the GPU time of the frame
+  GpuTimer& gpuTimer()
+  {
+    return _gpuTimer;
   }
+
+  RenderStats& stats()
+  {
+    return _stats;
+  }
+
+  const RenderStats& stats() const
+  {
+    return _stats;
+  }
+
+  static constexpr const char* defaultFont = "assets/fonts/ARIALBD.TTF-msdf";
+
   const Font& font(const std::filesystem::path& path);
 
+  // the font whose atlas the text bind groups sample, which is the first one
+  // loaded. Loads the default font if there is none yet.
+  const Font& atlasFont();
+
+  // uploads a font decoded ahead of time, e.g. on another thread
+  const Font& addFont(const std::filesystem::path& path, FontData data);
+
+  // one set of outlines per font and em size
+  GlyphOutlines& outlines(const std::filesystem::path& path, float emSize);
+
  private:
   void createSamplers();
 
   void createTextBuffers();
+  void createTextCharacterBuffer(size_t capacity);
   void createTextPipeline(wgpu::TextureFormat format);
   void flushText(const wgpu::RenderPassEncoder& renderPass);
 
+  void createStrokePipeline(wgpu::TextureFormat format);
+  void flushStrokes(const wgpu::RenderPassEncoder& renderPass);
+
+  struct AsyncPipeline
+  {
+    wgpu::RenderPipeline pipeline;
+    std::atomic<bool> done = false;
+  };
+
+  void createPipelineAsync(
+    const wgpu::RenderPipelineDescriptor& descriptor,
+    AsyncPipeline& target
+  );
+
+  // moves the staging lists on to a fresh frame of the arena
+  void nextFrame();
+
  private:
+  // backs the staging lists, which only live until their flush
+  util::FrameArena _frameArena;
+
   wgpu::Sampler _linearSampler;
   wgpu::Sampler _nearestSampler;
 
-  std::vector<TextCharacterGPU> _textCharacterData;
+  std::pmr::vector<TextCharacterGPU> _textCharacterData{&_frameArena};
   wgpu::Buffer _textCharacterBuffer;
+  size_t _textCharacterCapacity = 0;
   wgpu::Buffer _textUniformBuffer;
+  wgpu::BindGroupLayout _textBindGroupLayout;
   wgpu::BindGroup _textBindGroup;
-  wgpu::RenderPipeline _textPipeline;
+  wgpu::TextureView _textAtlasView;
+  const Font* _atlasFont = nullptr;
+  AsyncPipeline _textPipeline;
+
+  struct InstanceDraw
+  {
+    wgpu::BindGroup bindGroup;
+    uint32_t count;
+  };
+  std::pmr::vector<InstanceDraw> _instanceDraws{&_frameArena};
+
+  wgpu::BindGroupLayout _strokeBindGroupLayout;
+  AsyncPipeline _strokePipeline;
+  bool _pipelinesReady = false;
+  std::pmr::vector<InstanceDraw> _strokeDraws{&_frameArena};
 
   std::unordered_map<std::filesystem::path, graphics::Font> _fonts;
+  std::map<std::pair<std::filesystem::path, float>, graphics::GlyphOutlines>
+    _outlines;
+
+  GpuTimer _gpuTimer;
+  RenderStats _stats;
 
   const wgpu::Device& _device;
   const wgpu::Queue& _queue;
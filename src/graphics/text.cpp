@@ -1,9 +1,9 @@
 #include "text.h"
 
+#include "util/profiler.h"
+
 namespace graphics
 {
-constexpr float scalingFactor = 0.01f;
-
 Text::Text(std::string_view text, const Font& font) : _text(text), _font(font)
 {
   updateCharacters();
@@ -17,6 +17,7 @@ void Text::setAlignment(TextAlignment alignment)
   }
 
   _alignment = alignment;
+  _revision++;
   recalculateOrigin();
   recalculateAlignment();
 }
@@ -29,9 +30,35 @@ void Text::setColor(const glm::vec3& color)
   }
 
   _color = color;
+  _revision++;
+  for (auto& character : _characters)
+  {
+    character._data.color = glm::vec4(color, _opacity);
+  }
+}
+
+void Text::setOpacity(float opacity)
+{
+  if (_opacity == opacity)
+  {
+    return;
+  }
+
+  _opacity = opacity;
+  _revision++;
   for (auto& character : _characters)
   {
-    character._data.color = color;
+    character._data.color.a = opacity;
+  }
+}
+
+void Text::setEffect(const GlyphEffect& effect)
+{
+  _effect = effect;
+  _revision++;
+  for (auto& character : _characters)
+  {
+    updateEffect(character);
   }
 }
 
@@ -59,6 +86,16 @@ void Text::setFont(const Font& font)
 
 void Text::updateCharacters()
 {
+  TANIM_PROFILE_ZONE("Text::updateCharacters");
+
+  _revision++;
+
+  // the glyphs are destroyed below and must not stay behind as children of
+  // the text, the transform keeps its capacity for the new ones
+  for (auto it = _characters.rbegin(); it != _characters.rend(); ++it)
+  {
+    it->transform.setParent(nullptr);
+  }
   _characters.clear();
   _characters.reserve(_text.length());
 
@@ -82,6 +119,7 @@ void Text::updateCharacters()
     auto& fontChar = _font.get().character(_text.at(i));
 
     auto& textChar = _characters.emplace_back();
+    textChar._codepoint = (unsigned char)_text.at(i);
     textChar.transform.setParent(&transform);
     textChar._data.bounds = glm::vec4(
       fontChar.bounds.left,
@@ -90,7 +128,9 @@ void Text::updateCharacters()
       fontChar.bounds.bottom
     );
     textChar._data.size = fontChar.size;
-    textChar._data.color = _color;
+    textChar._data.color = glm::vec4(_color, _opacity);
+    textChar._data.index = (uint32_t)(_characters.size() - 1);
+    updateEffect(textChar);
     textChar._data.position.x = cursor.x + fontChar.offset.x;
     textChar._data.position.y = cursor.y - fontChar.offset.y;
 
@@ -100,8 +140,14 @@ void Text::updateCharacters()
         _font.get().kerning(_text.at(i - 1), _text.at(i));
     }
 
+    textChar._origin = glm::vec2(
+      textChar._data.position.x - fontChar.offset.x,
+      cursor.y - _font.get().base()
+    );
+
     textChar._data.size *= scalingFactor;
     textChar._data.position *= scalingFactor;
+    textChar._origin *= scalingFactor;
 
     textChar.transform.setOrigin(glm::vec3(
       textChar._data.position.x + textChar._data.size.x / 2.0f,
@@ -121,6 +167,18 @@ void Text::updateCharacters()
   recalculateAlignment();
 }
 
+void Text::updateEffect(TextCharacter& character) const
+{
+  character._data.effect = glm::vec4(
+    _effect.startTime,
+    _effect.stagger,
+    _effect.duration,
+    _effect.amplitude
+  );
+  character._data.effectType = (uint32_t)_effect.type;
+  character._data.effectEasing = (uint32_t)_effect.easing;
+}
+
 void Text::recalculateOrigin()
 {
   float halfLineHeight = _font.get().lineHeight() * scalingFactor / 2.0f;
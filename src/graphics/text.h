@@ -5,6 +5,7 @@
 #include <glm/gtx/quaternion.hpp>
 #include <string>
 
+#include "animation/easing.h"
 #include "graphics/font.h"
 #include "graphics/gpu_types.h"
 #include "util/transform.h"
@@ -18,6 +19,28 @@ enum class TextAlignment
   Right,
 };
 
+enum class GlyphEffectType : uint32_t
+{
+  None,
+  Typewriter,
+  Fade,
+  ScaleIn,
+  Wave,
+};
+
+// Per-glyph animation evaluated in the text vertex shader. Glyph i starts
+// at startTime + i * stagger and takes duration seconds, amplitude is the
+// height of the wave.
+struct GlyphEffect
+{
+  GlyphEffectType type = GlyphEffectType::None;
+  float startTime = 0.0f;
+  float stagger = 0.05f;
+  float duration = 0.5f;
+  float amplitude = 0.1f;
+  animation::Easing easing = animation::Easing::EaseOut;
+};
+
 class TextCharacter
 {
  public:
@@ -28,20 +51,43 @@ class TextCharacter
     return _data;
   }
 
+  uint32_t codepoint() const
+  {
+    return _codepoint;
+  }
+
+  // pen position of the glyph on its baseline, without alignment
+  const glm::vec2& origin() const
+  {
+    return _origin;
+  }
+
+  // alignment offset of the whole text
+  const glm::vec2& offset() const
+  {
+    return _offset;
+  }
+
  public:
   util::Transform transform;
 
  private:
   TextCharacterGPU _data;
+  uint32_t _codepoint = 0;
 
+  glm::vec2 _origin{0.0f};
   glm::vec2 _offset{0.0f};
 
   friend class Text;
+  friend class NumberText;
 };
 
 class Text
 {
  public:
+  // converts font pixels into layout units
+  static constexpr float scalingFactor = 0.01f;
+
   Text(std::string_view text, const Font& font);
   ~Text() = default;
 
@@ -57,6 +103,18 @@ class Text
   }
   void setColor(const glm::vec3& color);
 
+  float opacity() const
+  {
+    return _opacity;
+  }
+  void setOpacity(float opacity);
+
+  const GlyphEffect& effect() const
+  {
+    return _effect;
+  }
+  void setEffect(const GlyphEffect& effect);
+
   const std::string& text() const
   {
     return _text;
@@ -94,12 +152,20 @@ class Text
     return _height;
   }
 
+  // changes with every visible modification of the text or its transform
+  uint64_t revision() const
+  {
+    return _revision + transform.revision();
+  }
+
  public:
   util::Transform transform;
 
  private:
   void updateCharacters();
 
+  void updateEffect(TextCharacter& character) const;
+
   void recalculateOrigin();
 
   void recalculateAlignment();
@@ -108,6 +174,9 @@ class Text
   TextAlignment _alignment = TextAlignment::Left;
 
   glm::vec3 _color{1.0f};
+  float _opacity = 1.0f;
+
+  GlyphEffect _effect;
 
   std::string _text;
   std::reference_wrapper<const Font> _font;
@@ -116,6 +185,9 @@ class Text
   float _width;
   float _height;
 
+  uint64_t _revision = 0;
+
   friend class Renderer;
+  friend struct FrameData;
 };
 }  // namespace graphics
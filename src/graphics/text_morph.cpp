@@ -0,0 +1,315 @@
+#include "text_morph.h"
+
+#include <algorithm>
+#include <array>
+#include <glm/gtc/matrix_transform.hpp>
+#include <unordered_map>
+
+namespace graphics
+{
+constexpr uint32_t workgroupSize = 64;
+
+// instance data with the glyph position folded into the transform, so
+// interpolating two transforms moves the glyph along a straight line
+static TextCharacterGPU capture(TextCharacter& character)
+{
+  TextCharacterGPU data = character.data();
+  data.transform =
+    glm::translate(data.transform, glm::vec3(data.position, 0.0f));
+  data.position = glm::vec2(0.0f);
+  data.effectType = 0;
+  return data;
+}
+
+TextMorph::TextMorph(
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  Renderer& renderer,
+  Text& from,
+  Text& to
+)
+  : _stats(renderer.stats()),
+    _gpuTimer(renderer.gpuTimer()),
+    _device(device),
+    _queue(queue)
+{
+  std::vector<TextCharacterGPU> starts;
+  std::vector<TextCharacterGPU> ends;
+  match(from, to, starts, ends);
+
+  createBuffers(starts, ends);
+  createPipeline();
+  _renderBindGroup = renderer.createTextBindGroup(_characterBuffer);
+
+  update(0.0f);
+}
+
+void TextMorph::update(float progress)
+{
+  if (_count == 0)
+  {
+    return;
+  }
+
+  TextMorphUniformsGPU uniforms{};
+  uniforms.progress = std::clamp(progress, 0.0f, 1.0f);
+  uniforms.count = _count;
+  _queue.WriteBuffer(_uniformBuffer, 0, &uniforms, sizeof(uniforms));
+  _stats.upload(sizeof(uniforms));
+
+  wgpu::CommandEncoderDescriptor encoderDescriptor{};
+  encoderDescriptor.label = "Text Morph Command Encoder";
+  auto encoder = _device.CreateCommandEncoder(&encoderDescriptor);
+  _gpuTimer.begin();
+
+  wgpu::ComputePassDescriptor computePassDescriptor{};
+  computePassDescriptor.label = "Text Morph Compute Pass";
+  computePassDescriptor.timestampWrites =
+    _gpuTimer.computePass("Text Morph Compute Pass");
+
+  auto computePass = encoder.BeginComputePass(&computePassDescriptor);
+  computePass.SetPipeline(_pipeline);
+  computePass.SetBindGroup(0, _computeBindGroup);
+  computePass.DispatchWorkgroups(
+    (_count + workgroupSize - 1) / workgroupSize,
+    1,
+    1
+  );
+  computePass.End();
+  _gpuTimer.resolve(encoder);
+
+  wgpu::CommandBufferDescriptor commandDescriptor{};
+  commandDescriptor.label = "Text Morph Command Buffer";
+  auto command = encoder.Finish(&commandDescriptor);
+
+  _queue.Submit(1, &command);
+  _gpuTimer.submitted();
+}
+
+void TextMorph::draw(Renderer& renderer) const
+{
+  renderer.drawInstances(_renderBindGroup, _count);
+}
+
+void TextMorph::match(
+  Text& from,
+  Text& to,
+  std::vector<TextCharacterGPU>& starts,
+  std::vector<TextCharacterGPU>& ends
+)
+{
+  size_t fromCount = from.characters().size();
+  size_t toCount = to.characters().size();
+
+  // target glyphs per codepoint, pushed in reverse so popping from the back
+  // matches repeated glyphs in reading order
+  std::unordered_map<uint32_t, std::vector<uint32_t>> targets;
+  targets.reserve(toCount);
+  for (size_t i = toCount; i-- > 0;)
+  {
+    targets[to.character(i).codepoint()].push_back((uint32_t)i);
+  }
+
+  std::vector<bool> matched(toCount, false);
+  starts.reserve(fromCount + toCount);
+  ends.reserve(fromCount + toCount);
+
+  for (size_t i = 0; i < fromCount; i++)
+  {
+    auto start = capture(from.character(i));
+
+    auto it = targets.find(from.character(i).codepoint());
+    if (it != targets.end() && !it->second.empty())
+    {
+      uint32_t target = it->second.back();
+      it->second.pop_back();
+      matched[target] = true;
+
+      starts.push_back(start);
+      ends.push_back(capture(to.character(target)));
+      _matchedCount++;
+      continue;
+    }
+
+    auto end = start;
+    end.color.a = 0.0f;
+    starts.push_back(start);
+    ends.push_back(end);
+  }
+
+  for (size_t i = 0; i < toCount; i++)
+  {
+    if (matched[i])
+    {
+      continue;
+    }
+
+    auto end = capture(to.character(i));
+    auto start = end;
+    start.color.a = 0.0f;
+    starts.push_back(start);
+    ends.push_back(end);
+  }
+
+  _count = (uint32_t)starts.size();
+}
+
+void TextMorph::createBuffers(
+  const std::vector<TextCharacterGPU>& starts,
+  const std::vector<TextCharacterGPU>& ends
+)
+{
+  // zero sized bindings are invalid, keep room for at least one glyph
+  uint64_t size = std::max<uint64_t>(_count, 1) * sizeof(TextCharacterGPU);
+
+  wgpu::BufferDescriptor startBufferDescriptor{};
+  startBufferDescriptor.label = "Text Morph Start Buffer";
+  startBufferDescriptor.size = size;
+  startBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+  _startBuffer = _device.CreateBuffer(&startBufferDescriptor);
+
+  wgpu::BufferDescriptor endBufferDescriptor{};
+  endBufferDescriptor.label = "Text Morph End Buffer";
+  endBufferDescriptor.size = size;
+  endBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+  _endBuffer = _device.CreateBuffer(&endBufferDescriptor);
+
+  wgpu::BufferDescriptor characterBufferDescriptor{};
+  characterBufferDescriptor.label = "Text Morph Character Buffer";
+  characterBufferDescriptor.size = size;
+  characterBufferDescriptor.usage = wgpu::BufferUsage::Storage;
+  _characterBuffer = _device.CreateBuffer(&characterBufferDescriptor);
+
+  wgpu::BufferDescriptor uniformBufferDescriptor{};
+  uniformBufferDescriptor.label = "Text Morph Uniform Buffer";
+  uniformBufferDescriptor.size = sizeof(TextMorphUniformsGPU);
+  uniformBufferDescriptor.usage =
+    wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+  _uniformBuffer = _device.CreateBuffer(&uniformBufferDescriptor);
+
+  if (_count == 0)
+  {
+    return;
+  }
+
+  size_t dataSize = _count * sizeof(TextCharacterGPU);
+  _queue.WriteBuffer(_startBuffer, 0, starts.data(), dataSize);
+  _queue.WriteBuffer(_endBuffer, 0, ends.data(), dataSize);
+  _stats.upload(2 * dataSize);
+}
+
+void TextMorph::createPipeline()
+{
+  std::array<wgpu::BindGroupLayoutEntry, 4> bindGroupLayoutEntries{};
+  bindGroupLayoutEntries[0].binding = 0;
+  bindGroupLayoutEntries[0].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[0].buffer.type =
+    wgpu::BufferBindingType::ReadOnlyStorage;
+
+  bindGroupLayoutEntries[1].binding = 1;
+  bindGroupLayoutEntries[1].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[1].buffer.type =
+    wgpu::BufferBindingType::ReadOnlyStorage;
+
+  bindGroupLayoutEntries[2].binding = 2;
+  bindGroupLayoutEntries[2].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[2].buffer.type = wgpu::BufferBindingType::Storage;
+
+  bindGroupLayoutEntries[3].binding = 3;
+  bindGroupLayoutEntries[3].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[3].buffer.type = wgpu::BufferBindingType::Uniform;
+
+  wgpu::BindGroupLayoutDescriptor bindGroupLayoutDescriptor{};
+  bindGroupLayoutDescriptor.label = "Text Morph Bind Group Layout";
+  bindGroupLayoutDescriptor.entryCount =
+    (uint32_t)bindGroupLayoutEntries.size();
+  bindGroupLayoutDescriptor.entries = bindGroupLayoutEntries.data();
+  auto bindGroupLayout =
+    _device.CreateBindGroupLayout(&bindGroupLayoutDescriptor);
+
+  std::array<wgpu::BindGroupEntry, 4> bindGroupEntries{};
+  bindGroupEntries[0].buffer = _startBuffer;
+  bindGroupEntries[0].binding = 0;
+
+  bindGroupEntries[1].buffer = _endBuffer;
+  bindGroupEntries[1].binding = 1;
+
+  bindGroupEntries[2].buffer = _characterBuffer;
+  bindGroupEntries[2].binding = 2;
+
+  bindGroupEntries[3].buffer = _uniformBuffer;
+  bindGroupEntries[3].binding = 3;
+
+  wgpu::BindGroupDescriptor bindGroupDescriptor{};
+  bindGroupDescriptor.label = "Text Morph Bind Group";
+  bindGroupDescriptor.entryCount = bindGroupEntries.size();
+  bindGroupDescriptor.entries = bindGroupEntries.data();
+  bindGroupDescriptor.layout = bindGroupLayout;
+  _computeBindGroup = _device.CreateBindGroup(&bindGroupDescriptor);
+
+  const char* shaderCode = R"(
+    struct TextCharacter {
+      transform: mat4x4<f32>,
+      bounds: vec4f,
+      color: vec4f,
+      size: vec2f,
+      position: vec2f,
+      effect: vec4f,
+      effectType: u32,
+      effectEasing: u32,
+      index: u32,
+    };
+
+    struct Uniforms {
+      progress: f32,
+      count: u32,
+    };
+
+    @group(0) @binding(0) var<storage, read> starts: array<TextCharacter>;
+    @group(0) @binding(1) var<storage, read> ends: array<TextCharacter>;
+    @group(0) @binding(2) var<storage, read_write> characters: array<TextCharacter>;
+    @group(0) @binding(3) var<uniform> uniforms: Uniforms;
+
+    @compute @workgroup_size(64)
+    fn csMain(@builtin(global_invocation_id) id: vec3u) {
+      let i = id.x;
+      if (i >= uniforms.count) {
+        return;
+      }
+
+      let t = uniforms.progress;
+      let start = starts[i];
+      var character = ends[i];
+      character.transform =
+        start.transform * (1.0 - t) + character.transform * t;
+      character.color = mix(start.color, character.color, t);
+      characters[i] = character;
+    }
+)";
+
+  wgpu::ShaderModuleWGSLDescriptor wgslDescriptor{};
+  wgslDescriptor.code = shaderCode;
+  wgslDescriptor.sType = wgpu::SType::ShaderSourceWGSL;
+
+  wgpu::ShaderModuleDescriptor shaderModuleDescriptor{};
+  shaderModuleDescriptor.label = "Text Morph Shader Module";
+  shaderModuleDescriptor.nextInChain = &wgslDescriptor;
+
+  wgpu::ShaderModule shaderModule =
+    _device.CreateShaderModule(&shaderModuleDescriptor);
+
+  wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{};
+  pipelineLayoutDescriptor.label = "Text Morph Pipeline Layout";
+  pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
+  pipelineLayoutDescriptor.bindGroupLayouts = &bindGroupLayout;
+  auto pipelineLayout = _device.CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+  wgpu::ComputePipelineDescriptor pipelineDescriptor{};
+  pipelineDescriptor.label = "Text Morph Pipeline";
+  pipelineDescriptor.compute.module = shaderModule;
+  pipelineDescriptor.layout = pipelineLayout;
+  _pipeline = _device.CreateComputePipeline(&pipelineDescriptor);
+}
+}  // namespace graphics
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "graphics/gpu_types.h"
+#include "graphics/renderer.h"
+#include "graphics/text.h"
+
+namespace graphics
+{
+struct TextMorphUniformsGPU
+{
+  float progress;
+  uint32_t count;
+};
+
+// Transition between the layouts of two texts. Glyphs with the same
+// codepoint are matched in order and fly from their old to their new
+// position, the remaining glyphs fade out or in.
+//
+// Both layouts are captured once on construction, every update only writes
+// the progress and runs a compute pass interpolating the instances.
+class TextMorph
+{
+ public:
+  TextMorph(
+    const wgpu::Device& device,
+    const wgpu::Queue& queue,
+    Renderer& renderer,
+    Text& from,
+    Text& to
+  );
+  ~TextMorph() = default;
+
+  TextMorph(const TextMorph&) = delete;
+  TextMorph& operator=(const TextMorph&) = delete;
+
+  void update(float progress);
+
+  void draw(Renderer& renderer) const;
+
+  uint32_t count() const
+  {
+    return _count;
+  }
+
+  uint32_t matchedCount() const
+  {
+    return _matchedCount;
+  }
+
+ private:
+  void match(
+    Text& from,
+    Text& to,
+    std::vector<TextCharacterGPU>& starts,
+    std::vector<TextCharacterGPU>& ends
+  );
+
+  void createBuffers(
+    const std::vector<TextCharacterGPU>& starts,
+    const std::vector<TextCharacterGPU>& ends
+  );
+  void createPipeline();
+
+ private:
+  uint32_t _count = 0;
+  uint32_t _matchedCount = 0;
+
+  wgpu::Buffer _startBuffer;
+  wgpu::Buffer _endBuffer;
+  wgpu::Buffer _characterBuffer;
+  wgpu::Buffer _uniformBuffer;
+  wgpu::BindGroup _computeBindGroup;
+  wgpu::BindGroup _renderBindGroup;
+  wgpu::ComputePipeline _pipeline;
+
+  RenderStats& _stats;
+  GpuTimer& _gpuTimer;
+
+  const wgpu::Device& _device;
+  const wgpu::Queue& _queue;
+};
+}  // namespace graphics
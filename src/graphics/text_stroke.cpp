@@ -0,0 +1,94 @@
+#include "text_stroke.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace graphics
+{
+TextStroke::TextStroke(
+  Renderer& renderer,
+  GlyphOutlines& outlines,
+  Text& text,
+  float thickness
+)
+  : _thickness(thickness),
+    _stats(renderer.stats()),
+    _queue(renderer.queue())
+{
+  std::vector<StrokeSegmentGPU> segments;
+  for (const auto& character : text.characters())
+  {
+    const auto& glyph = outlines.glyph(character.codepoint());
+    glm::vec2 origin = character.origin() + character.offset();
+
+    for (size_t c = 0; c + 1 < glyph.contourStarts.size(); c++)
+    {
+      for (uint32_t i = glyph.contourStarts[c] + 1;
+           i < glyph.contourStarts[c + 1];
+           i++)
+      {
+        auto& segment = segments.emplace_back();
+        segment.start = origin + glyph.points[i - 1];
+        segment.end = origin + glyph.points[i];
+        segment.lengths = glm::vec2(
+          _length + glyph.lengths[i - 1],
+          _length + glyph.lengths[i]
+        );
+      }
+    }
+    _length += glyph.length;
+  }
+  _segmentCount = (uint32_t)segments.size();
+
+  const auto& device = renderer.device();
+
+  // zero sized bindings are invalid, keep room for at least one segment
+  wgpu::BufferDescriptor segmentBufferDescriptor{};
+  segmentBufferDescriptor.label = "Text Stroke Segment Buffer";
+  segmentBufferDescriptor.size =
+    std::max<uint64_t>(_segmentCount, 1) * sizeof(StrokeSegmentGPU);
+  segmentBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+  _segmentBuffer = device.CreateBuffer(&segmentBufferDescriptor);
+
+  wgpu::BufferDescriptor uniformBufferDescriptor{};
+  uniformBufferDescriptor.label = "Text Stroke Uniform Buffer";
+  uniformBufferDescriptor.size = sizeof(StrokeUniformsGPU);
+  uniformBufferDescriptor.usage =
+    wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+  _uniformBuffer = device.CreateBuffer(&uniformBufferDescriptor);
+
+  if (_segmentCount > 0)
+  {
+    _queue.WriteBuffer(
+      _segmentBuffer,
+      0,
+      segments.data(),
+      segments.size() * sizeof(StrokeSegmentGPU)
+    );
+    _stats.upload(segments.size() * sizeof(StrokeSegmentGPU));
+  }
+
+  _bindGroup = renderer.createStrokeBindGroup(_segmentBuffer, _uniformBuffer);
+}
+
+void TextStroke::update(
+  const glm::mat4& transform,
+  const glm::vec4& color,
+  float progress
+)
+{
+  StrokeUniformsGPU uniforms{};
+  uniforms.transform = transform;
+  uniforms.color = color;
+  uniforms.reveal = std::clamp(progress, 0.0f, 1.0f) * _length;
+  uniforms.thickness = _thickness;
+  _queue.WriteBuffer(_uniformBuffer, 0, &uniforms, sizeof(uniforms));
+  _stats.upload(sizeof(uniforms));
+}
+
+void TextStroke::draw(Renderer& renderer) const
+{
+  renderer.drawStrokes(_bindGroup, _segmentCount);
+}
+}  // namespace graphics
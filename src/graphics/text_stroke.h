@@ -0,0 +1,74 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "graphics/glyph_outlines.h"
+#include "graphics/renderer.h"
+#include "graphics/text.h"
+
+namespace graphics
+{
+// Outlines of a text as line segments, revealed along their arc length to
+// draw the text stroke by stroke. Glyphs are written one after another.
+//
+// The segments are built and uploaded once, drawing only updates a small
+// uniform with the transform and the revealed length.
+class TextStroke
+{
+ public:
+  TextStroke(
+    Renderer& renderer,
+    GlyphOutlines& outlines,
+    Text& text,
+    float thickness = 0.01f
+  );
+  ~TextStroke() = default;
+
+  TextStroke(const TextStroke&) = delete;
+  TextStroke& operator=(const TextStroke&) = delete;
+
+  // progress in [0, 1] of the total outline length
+  void update(
+    const glm::mat4& transform,
+    const glm::vec4& color,
+    float progress
+  );
+
+  void draw(Renderer& renderer) const;
+
+  float length() const
+  {
+    return _length;
+  }
+
+  uint32_t segmentCount() const
+  {
+    return _segmentCount;
+  }
+
+  float thickness() const
+  {
+    return _thickness;
+  }
+  void setThickness(float thickness)
+  {
+    _thickness = thickness;
+  }
+
+ private:
+  float _thickness;
+  float _length = 0.0f;
+  uint32_t _segmentCount = 0;
+
+  wgpu::Buffer _segmentBuffer;
+  wgpu::Buffer _uniformBuffer;
+  wgpu::BindGroup _bindGroup;
+
+  RenderStats& _stats;
+
+  const wgpu::Queue& _queue;
+};
+}  // namespace graphics
@@ -0,0 +1,361 @@
+#include "truetype.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace graphics
+{
+// composite glyphs may reference other composites, but never this deep
+constexpr uint32_t maxCompositeDepth = 8;
+
+// simple glyph flags
+constexpr uint8_t onCurvePoint = 0x01;
+constexpr uint8_t xShortVector = 0x02;
+constexpr uint8_t yShortVector = 0x04;
+constexpr uint8_t repeatFlag = 0x08;
+constexpr uint8_t xSameOrPositive = 0x10;
+constexpr uint8_t ySameOrPositive = 0x20;
+
+// composite glyph flags
+constexpr uint16_t argsAreWords = 0x0001;
+constexpr uint16_t argsAreXYValues = 0x0002;
+constexpr uint16_t weHaveAScale = 0x0008;
+constexpr uint16_t moreComponents = 0x0020;
+constexpr uint16_t weHaveAnXAndYScale = 0x0040;
+constexpr uint16_t weHaveATwoByTwo = 0x0080;
+
+TrueTypeFont::TrueTypeFont(const std::filesystem::path& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+  {
+    throw std::runtime_error("Could not open " + path.string());
+  }
+  _data.assign(
+    std::istreambuf_iterator<char>(file),
+    std::istreambuf_iterator<char>()
+  );
+
+  size_t head = table("head");
+  _unitsPerEm = u16(head + 18);
+  _longLoca = i16(head + 50) != 0;
+
+  _glyphCount = u16(table("maxp") + 4);
+  _loca = table("loca");
+  _glyf = table("glyf");
+
+  findCharacterMap();
+}
+
+uint32_t TrueTypeFont::glyphIndex(uint32_t codepoint) const
+{
+  size_t map = _characterMap;
+  if (_characterMapFormat == 4)
+  {
+    if (codepoint > 0xFFFF)
+    {
+      return 0;
+    }
+
+    uint16_t segmentCount = u16(map + 6) / 2;
+    size_t endCodes = map + 14;
+    size_t startCodes = endCodes + segmentCount * 2 + 2;
+    size_t idDeltas = startCodes + segmentCount * 2;
+    size_t idRangeOffsets = idDeltas + segmentCount * 2;
+
+    for (uint16_t i = 0; i < segmentCount; i++)
+    {
+      if (u16(endCodes + i * 2) < codepoint)
+      {
+        continue;
+      }
+
+      uint16_t startCode = u16(startCodes + i * 2);
+      if (startCode > codepoint)
+      {
+        return 0;
+      }
+
+      uint16_t idDelta = u16(idDeltas + i * 2);
+      size_t rangeOffset = idRangeOffsets + i * 2;
+      uint16_t idRangeOffset = u16(rangeOffset);
+      if (idRangeOffset == 0)
+      {
+        return (uint16_t)(codepoint + idDelta);
+      }
+
+      uint16_t glyph =
+        u16(rangeOffset + idRangeOffset + (codepoint - startCode) * 2);
+      return glyph == 0 ? 0 : (uint16_t)(glyph + idDelta);
+    }
+    return 0;
+  }
+
+  uint32_t groupCount = u32(map + 12);
+  for (uint32_t i = 0; i < groupCount; i++)
+  {
+    size_t group = map + 16 + i * 12;
+    uint32_t startCode = u32(group);
+    uint32_t endCode = u32(group + 4);
+    if (codepoint >= startCode && codepoint <= endCode)
+    {
+      return u32(group + 8) + (codepoint - startCode);
+    }
+  }
+  return 0;
+}
+
+std::vector<OutlineContour> TrueTypeFont::outline(uint32_t codepoint) const
+{
+  std::vector<OutlineContour> contours;
+  glyphOutline(glyphIndex(codepoint), glm::mat3(1.0f), contours, 0);
+  return contours;
+}
+
+uint8_t TrueTypeFont::u8(size_t offset) const
+{
+  if (offset + 1 > _data.size())
+  {
+    throw std::runtime_error("TrueType read out of bounds");
+  }
+  return _data[offset];
+}
+
+uint16_t TrueTypeFont::u16(size_t offset) const
+{
+  return (uint16_t)(u8(offset) << 8 | u8(offset + 1));
+}
+
+int16_t TrueTypeFont::i16(size_t offset) const
+{
+  return (int16_t)u16(offset);
+}
+
+uint32_t TrueTypeFont::u32(size_t offset) const
+{
+  return (uint32_t)u16(offset) << 16 | u16(offset + 2);
+}
+
+size_t TrueTypeFont::table(const char* tag) const
+{
+  uint16_t tableCount = u16(4);
+  for (uint16_t i = 0; i < tableCount; i++)
+  {
+    size_t record = 12 + i * 16;
+    if (record + 4 <= _data.size() &&
+        std::memcmp(&_data[record], tag, 4) == 0)
+    {
+      return u32(record + 8);
+    }
+  }
+  throw std::runtime_error(std::string("TrueType table missing: ") + tag);
+}
+
+void TrueTypeFont::findCharacterMap()
+{
+  size_t cmap = table("cmap");
+  uint16_t subtableCount = u16(cmap + 2);
+
+  // prefer the full unicode map (format 12) over the BMP one (format 4)
+  for (uint16_t i = 0; i < subtableCount; i++)
+  {
+    size_t record = cmap + 4 + i * 8;
+    uint16_t platform = u16(record);
+    size_t subtable = cmap + u32(record + 4);
+    uint16_t format = u16(subtable);
+    if (platform != 0 && platform != 3)
+    {
+      continue;
+    }
+
+    if (format == 12 || (format == 4 && _characterMapFormat != 12))
+    {
+      _characterMap = subtable;
+      _characterMapFormat = format;
+    }
+  }
+
+  if (_characterMapFormat == 0)
+  {
+    throw std::runtime_error("TrueType font has no unicode character map");
+  }
+}
+
+void TrueTypeFont::glyphOutline(
+  uint32_t glyph,
+  const glm::mat3& transform,
+  std::vector<OutlineContour>& contours,
+  uint32_t depth
+) const
+{
+  if (glyph >= _glyphCount || depth > maxCompositeDepth)
+  {
+    return;
+  }
+
+  size_t start = _longLoca ? u32(_loca + glyph * 4)
+                           : (size_t)u16(_loca + glyph * 2) * 2;
+  size_t end = _longLoca ? u32(_loca + glyph * 4 + 4)
+                         : (size_t)u16(_loca + glyph * 2 + 2) * 2;
+  if (start == end)
+  {
+    // glyphs without outline, e.g. space
+    return;
+  }
+
+  size_t offset = _glyf + start;
+  int16_t contourCount = i16(offset);
+  if (contourCount >= 0)
+  {
+    simpleGlyphOutline(offset, contourCount, transform, contours);
+  }
+  else
+  {
+    compositeGlyphOutline(offset, transform, contours, depth);
+  }
+}
+
+void TrueTypeFont::simpleGlyphOutline(
+  size_t offset,
+  int16_t contourCount,
+  const glm::mat3& transform,
+  std::vector<OutlineContour>& contours
+) const
+{
+  size_t endPoints = offset + 10;
+  if (contourCount == 0)
+  {
+    return;
+  }
+  uint16_t pointCount = u16(endPoints + (contourCount - 1) * 2) + 1;
+
+  size_t instructionLength = u16(endPoints + contourCount * 2);
+  size_t cursor = endPoints + contourCount * 2 + 2 + instructionLength;
+
+  std::vector<uint8_t> flags(pointCount);
+  for (uint16_t i = 0; i < pointCount;)
+  {
+    uint8_t flag = u8(cursor++);
+    uint8_t repeat = (flag & repeatFlag) ? u8(cursor++) : 0;
+    for (uint16_t r = 0; r <= repeat && i < pointCount; r++)
+    {
+      flags[i++] = flag;
+    }
+  }
+
+  std::vector<glm::vec2> points(pointCount);
+  int32_t x = 0;
+  for (uint16_t i = 0; i < pointCount; i++)
+  {
+    if (flags[i] & xShortVector)
+    {
+      uint8_t dx = u8(cursor++);
+      x += (flags[i] & xSameOrPositive) ? dx : -dx;
+    }
+    else if (!(flags[i] & xSameOrPositive))
+    {
+      x += i16(cursor);
+      cursor += 2;
+    }
+    points[i].x = (float)x;
+  }
+
+  int32_t y = 0;
+  for (uint16_t i = 0; i < pointCount; i++)
+  {
+    if (flags[i] & yShortVector)
+    {
+      uint8_t dy = u8(cursor++);
+      y += (flags[i] & ySameOrPositive) ? dy : -dy;
+    }
+    else if (!(flags[i] & ySameOrPositive))
+    {
+      y += i16(cursor);
+      cursor += 2;
+    }
+    points[i].y = (float)y;
+  }
+
+  uint16_t first = 0;
+  for (int16_t c = 0; c < contourCount; c++)
+  {
+    uint16_t last = u16(endPoints + c * 2);
+    auto& contour = contours.emplace_back();
+    for (uint16_t i = first; i <= last && i < pointCount; i++)
+    {
+      glm::vec3 point = transform * glm::vec3(points[i], 1.0f);
+      contour.push_back({glm::vec2(point), (flags[i] & onCurvePoint) != 0});
+    }
+    first = last + 1;
+  }
+}
+
+void TrueTypeFont::compositeGlyphOutline(
+  size_t offset,
+  const glm::mat3& transform,
+  std::vector<OutlineContour>& contours,
+  uint32_t depth
+) const
+{
+  auto f2dot14 = [&](size_t at) { return (float)i16(at) / 16384.0f; };
+
+  size_t cursor = offset + 10;
+  uint16_t flags = 0;
+  do
+  {
+    flags = u16(cursor);
+    uint16_t glyph = u16(cursor + 2);
+    cursor += 4;
+
+    float dx = 0.0f;
+    float dy = 0.0f;
+    if (flags & argsAreWords)
+    {
+      dx = (float)i16(cursor);
+      dy = (float)i16(cursor + 2);
+      cursor += 4;
+    }
+    else
+    {
+      dx = (float)(int8_t)u8(cursor);
+      dy = (float)(int8_t)u8(cursor + 1);
+      cursor += 2;
+    }
+
+    // point matching anchors are rare in practice and are placed at the
+    // origin of the parent glyph
+    if (!(flags & argsAreXYValues))
+    {
+      dx = 0.0f;
+      dy = 0.0f;
+    }
+
+    glm::mat3 component(1.0f);
+    if (flags & weHaveAScale)
+    {
+      component[0][0] = component[1][1] = f2dot14(cursor);
+      cursor += 2;
+    }
+    else if (flags & weHaveAnXAndYScale)
+    {
+      component[0][0] = f2dot14(cursor);
+      component[1][1] = f2dot14(cursor + 2);
+      cursor += 4;
+    }
+    else if (flags & weHaveATwoByTwo)
+    {
+      component[0][0] = f2dot14(cursor);
+      component[0][1] = f2dot14(cursor + 2);
+      component[1][0] = f2dot14(cursor + 4);
+      component[1][1] = f2dot14(cursor + 6);
+      cursor += 8;
+    }
+    component[2][0] = dx;
+    component[2][1] = dy;
+
+    glyphOutline(glyph, transform * component, contours, depth + 1);
+  } while (flags & moreComponents);
+}
+}  // namespace graphics
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace graphics
+{
+struct OutlinePoint
+{
+  glm::vec2 position;
+  bool onCurve;
+};
+
+// closed contour of quadratic curves, off curve points are control points
+using OutlineContour = std::vector<OutlinePoint>;
+
+// Minimal TrueType reader for glyph outlines (cmap formats 4 and 12, simple
+// and composite glyf entries). Hinting and CFF outlines are not supported.
+class TrueTypeFont
+{
+ public:
+  TrueTypeFont(const std::filesystem::path& path);
+  ~TrueTypeFont() = default;
+
+  uint32_t glyphIndex(uint32_t codepoint) const;
+
+  // contours in font units, y pointing up from the baseline
+  std::vector<OutlineContour> outline(uint32_t codepoint) const;
+
+  uint16_t unitsPerEm() const
+  {
+    return _unitsPerEm;
+  }
+
+ private:
+  uint8_t u8(size_t offset) const;
+  uint16_t u16(size_t offset) const;
+  int16_t i16(size_t offset) const;
+  uint32_t u32(size_t offset) const;
+
+  size_t table(const char* tag) const;
+  void findCharacterMap();
+
+  void glyphOutline(
+    uint32_t glyph,
+    const glm::mat3& transform,
+    std::vector<OutlineContour>& contours,
+    uint32_t depth
+  ) const;
+  void simpleGlyphOutline(
+    size_t offset,
+    int16_t contourCount,
+    const glm::mat3& transform,
+    std::vector<OutlineContour>& contours
+  ) const;
+  void compositeGlyphOutline(
+    size_t offset,
+    const glm::mat3& transform,
+    std::vector<OutlineContour>& contours,
+    uint32_t depth
+  ) const;
+
+ private:
+  std::vector<uint8_t> _data;
+
+  uint16_t _unitsPerEm = 0;
+  uint16_t _glyphCount = 0;
+  bool _longLoca = false;
+
+  size_t _loca = 0;
+  size_t _glyf = 0;
+  size_t _characterMap = 0;
+  uint16_t _characterMapFormat = 0;
+};
+}  // namespace graphics
@@ -0,0 +1,265 @@
+#include "yuv_converter.h"
+
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace graphics
+{
+// every invocation converts a block of 8x2 pixels, which keeps all plane
+// writes aligned to whole u32 words
+constexpr uint32_t blockWidth = 8;
+constexpr uint32_t blockHeight = 2;
+constexpr uint32_t workgroupSize = 8;
+
+YuvConverter::YuvConverter(
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  GpuTimer& gpuTimer,
+  uint32_t width,
+  uint32_t height
+)
+  : _width(width),
+    _height(height),
+    _gpuTimer(gpuTimer),
+    _device(device),
+    _queue(queue)
+{
+  if (width % blockWidth != 0 || height % blockHeight != 0)
+  {
+    throw std::runtime_error(
+      "YUV420 conversion requires a width divisible by 8 and an even height"
+    );
+  }
+
+  createBuffers();
+  createPipeline();
+}
+
+void YuvConverter::convert(const wgpu::TextureView& source)
+{
+  if (_source.Get() != source.Get())
+  {
+    createBindGroup(source);
+  }
+
+  wgpu::CommandEncoderDescriptor encoderDescriptor{};
+  encoderDescriptor.label = "YUV Converter Command Encoder";
+  auto encoder = _device.CreateCommandEncoder(&encoderDescriptor);
+  _gpuTimer.begin();
+
+  wgpu::ComputePassDescriptor computePassDescriptor{};
+  computePassDescriptor.label = "YUV Converter Compute Pass";
+  computePassDescriptor.timestampWrites =
+    _gpuTimer.computePass("YUV Converter Compute Pass");
+
+  auto computePass = encoder.BeginComputePass(&computePassDescriptor);
+  computePass.SetPipeline(_pipeline);
+  computePass.SetBindGroup(0, _bindGroup);
+  computePass.DispatchWorkgroups(
+    (_width / blockWidth + workgroupSize - 1) / workgroupSize,
+    (_height / blockHeight + workgroupSize - 1) / workgroupSize,
+    1
+  );
+  computePass.End();
+
+  encoder.CopyBufferToBuffer(
+    _planeBuffer,
+    0,
+    _readbackBuffer,
+    0,
+    _planeBuffer.GetSize()
+  );
+  _gpuTimer.resolve(encoder);
+
+  wgpu::CommandBufferDescriptor commandDescriptor{};
+  commandDescriptor.label = "YUV Converter Command Buffer";
+  auto command = encoder.Finish(&commandDescriptor);
+
+  _queue.Submit(1, &command);
+  _gpuTimer.submitted();
+}
+
+bool YuvConverter::read(
+  const wgpu::Instance& instance,
+  std::vector<uint8_t>& planes
+)
+{
+  bool mapped = false;
+  instance.WaitAny(
+    _readbackBuffer.MapAsync(
+      wgpu::MapMode::Read,
+      0,
+      _readbackBuffer.GetSize(),
+      wgpu::CallbackMode::WaitAnyOnly,
+      [](wgpu::MapAsyncStatus status, wgpu::StringView message, bool* outMapped)
+      {
+        *outMapped = status == wgpu::MapAsyncStatus::Success;
+        if (!*outMapped)
+        {
+          std::cerr << "[WebGPU] Failed to map YUV readback buffer: "
+                    << message << std::endl;
+        }
+      },
+      &mapped
+    ),
+    UINT64_MAX
+  );
+
+  if (!mapped)
+  {
+    return false;
+  }
+
+  planes.resize(frameSize());
+  std::memcpy(
+    planes.data(),
+    _readbackBuffer.GetConstMappedRange(0, frameSize()),
+    frameSize()
+  );
+  _readbackBuffer.Unmap();
+  return true;
+}
+
+void YuvConverter::createBuffers()
+{
+  wgpu::BufferDescriptor planeBufferDescriptor{};
+  planeBufferDescriptor.label = "YUV Converter Plane Buffer";
+  planeBufferDescriptor.size = frameSize();
+  planeBufferDescriptor.usage =
+    wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc;
+  _planeBuffer = _device.CreateBuffer(&planeBufferDescriptor);
+
+  wgpu::BufferDescriptor readbackBufferDescriptor{};
+  readbackBufferDescriptor.label = "YUV Converter Readback Buffer";
+  readbackBufferDescriptor.size = frameSize();
+  readbackBufferDescriptor.usage =
+    wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+  _readbackBuffer = _device.CreateBuffer(&readbackBufferDescriptor);
+}
+
+void YuvConverter::createPipeline()
+{
+  std::array<wgpu::BindGroupLayoutEntry, 2> bindGroupLayoutEntries{};
+  bindGroupLayoutEntries[0].binding = 0;
+  bindGroupLayoutEntries[0].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[0].texture.sampleType =
+    wgpu::TextureSampleType::UnfilterableFloat;
+  bindGroupLayoutEntries[0].texture.viewDimension =
+    wgpu::TextureViewDimension::e2D;
+
+  bindGroupLayoutEntries[1].binding = 1;
+  bindGroupLayoutEntries[1].visibility = wgpu::ShaderStage::Compute;
+  bindGroupLayoutEntries[1].buffer.type = wgpu::BufferBindingType::Storage;
+
+  wgpu::BindGroupLayoutDescriptor bindGroupLayoutDescriptor{};
+  bindGroupLayoutDescriptor.label = "YUV Converter Bind Group Layout";
+  bindGroupLayoutDescriptor.entryCount =
+    (uint32_t)bindGroupLayoutEntries.size();
+  bindGroupLayoutDescriptor.entries = bindGroupLayoutEntries.data();
+  _bindGroupLayout = _device.CreateBindGroupLayout(&bindGroupLayoutDescriptor);
+
+  const char* shaderCode = R"(
+    @group(0) @binding(0) var source: texture_2d<f32>;
+    @group(0) @binding(1) var<storage, read_write> planes: array<u32>;
+
+    fn luma(c: vec3f) -> f32 {
+      return dot(c, vec3f(0.2126, 0.7152, 0.0722));
+    }
+
+    // limited range: Y in [16, 235], Cb/Cr in [16, 240]
+    fn lumaByte(y: f32) -> f32 {
+      return (16.0 + 219.0 * y) / 255.0;
+    }
+
+    fn chromaByte(c: f32) -> f32 {
+      return (128.0 + 224.0 * c) / 255.0;
+    }
+
+    @compute @workgroup_size(8, 8)
+    fn csMain(@builtin(global_invocation_id) id: vec3u) {
+      let size = textureDimensions(source, 0);
+      let x0 = id.x * 8u;
+      let y0 = id.y * 2u;
+      if (x0 >= size.x || y0 >= size.y) {
+        return;
+      }
+
+      var chroma = array<vec3f, 4>();
+      for (var row = 0u; row < 2u; row++) {
+        var lumas = array<f32, 8>();
+        for (var i = 0u; i < 8u; i++) {
+          let c = textureLoad(source, vec2u(x0 + i, y0 + row), 0).rgb;
+          lumas[i] = lumaByte(luma(c));
+          chroma[i / 2u] += c;
+        }
+
+        let yIndex = ((y0 + row) * size.x + x0) / 4u;
+        planes[yIndex] = pack4x8unorm(
+          vec4f(lumas[0], lumas[1], lumas[2], lumas[3])
+        );
+        planes[yIndex + 1u] = pack4x8unorm(
+          vec4f(lumas[4], lumas[5], lumas[6], lumas[7])
+        );
+      }
+
+      var u = vec4f();
+      var v = vec4f();
+      for (var i = 0u; i < 4u; i++) {
+        let c = chroma[i] * 0.25;
+        let y = luma(c);
+        u[i] = chromaByte((c.b - y) / 1.8556);
+        v[i] = chromaByte((c.r - y) / 1.5748);
+      }
+
+      let lumaSize = size.x * size.y;
+      let chromaIndex = (y0 / 2u) * (size.x / 2u) + x0 / 2u;
+      planes[(lumaSize + chromaIndex) / 4u] = pack4x8unorm(u);
+      planes[(lumaSize + lumaSize / 4u + chromaIndex) / 4u] = pack4x8unorm(v);
+    }
+)";
+
+  wgpu::ShaderModuleWGSLDescriptor wgslDescriptor{};
+  wgslDescriptor.code = shaderCode;
+  wgslDescriptor.sType = wgpu::SType::ShaderSourceWGSL;
+
+  wgpu::ShaderModuleDescriptor shaderModuleDescriptor{};
+  shaderModuleDescriptor.label = "YUV Converter Shader Module";
+  shaderModuleDescriptor.nextInChain = &wgslDescriptor;
+
+  wgpu::ShaderModule shaderModule =
+    _device.CreateShaderModule(&shaderModuleDescriptor);
+
+  wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{};
+  pipelineLayoutDescriptor.label = "YUV Converter Pipeline Layout";
+  pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
+  pipelineLayoutDescriptor.bindGroupLayouts = &_bindGroupLayout;
+  auto pipelineLayout = _device.CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+  wgpu::ComputePipelineDescriptor pipelineDescriptor{};
+  pipelineDescriptor.label = "YUV Converter Pipeline";
+  pipelineDescriptor.compute.module = shaderModule;
+  pipelineDescriptor.layout = pipelineLayout;
+  _pipeline = _device.CreateComputePipeline(&pipelineDescriptor);
+}
+
+void YuvConverter::createBindGroup(const wgpu::TextureView& source)
+{
+  _source = source;
+
+  std::array<wgpu::BindGroupEntry, 2> bindGroupEntries{};
+  bindGroupEntries[0].textureView = source;
+  bindGroupEntries[0].binding = 0;
+
+  bindGroupEntries[1].buffer = _planeBuffer;
+  bindGroupEntries[1].binding = 1;
+
+  wgpu::BindGroupDescriptor bindGroupDescriptor{};
+  bindGroupDescriptor.label = "YUV Converter Bind Group";
+  bindGroupDescriptor.entryCount = bindGroupEntries.size();
+  bindGroupDescriptor.entries = bindGroupEntries.data();
+  bindGroupDescriptor.layout = _bindGroupLayout;
+  _bindGroup = _device.CreateBindGroup(&bindGroupDescriptor);
+}
+}  // namespace graphics
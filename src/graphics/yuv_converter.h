@@ -0,0 +1,67 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "graphics/gpu_timer.h"
+
+namespace graphics
+{
+// Converts an RGBA frame into planar YUV420 (BT.709, limited range) with a
+// compute pass, so only 1.5 bytes per pixel have to be read back.
+class YuvConverter
+{
+ public:
+  YuvConverter(
+    const wgpu::Device& device,
+    const wgpu::Queue& queue,
+    GpuTimer& gpuTimer,
+    uint32_t width,
+    uint32_t height
+  );
+  ~YuvConverter() = default;
+
+  void convert(const wgpu::TextureView& source);
+
+  // waits for the converted frame, false if it could not be read back
+  bool read(const wgpu::Instance& instance, std::vector<uint8_t>& planes);
+
+  uint32_t width() const
+  {
+    return _width;
+  }
+
+  uint32_t height() const
+  {
+    return _height;
+  }
+
+  size_t frameSize() const
+  {
+    return (size_t)_width * _height * 3 / 2;
+  }
+
+ private:
+  void createBuffers();
+  void createPipeline();
+  void createBindGroup(const wgpu::TextureView& source);
+
+ private:
+  uint32_t _width;
+  uint32_t _height;
+
+  wgpu::Buffer _planeBuffer;
+  wgpu::Buffer _readbackBuffer;
+  wgpu::BindGroupLayout _bindGroupLayout;
+  wgpu::BindGroup _bindGroup;
+  wgpu::TextureView _source;
+  wgpu::ComputePipeline _pipeline;
+
+  GpuTimer& _gpuTimer;
+
+  const wgpu::Device& _device;
+  const wgpu::Queue& _queue;
+};
+}  // namespace graphics
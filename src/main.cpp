@@ -2,40 +2,576 @@
 #include <dawn/webgpu_cpp_print.h>
 #include <webgpu/webgpu_cpp.h>
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <iostream>
+#include <limits>
 #include <nlohmann/json.hpp>
 #include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "animation/clock.h"
+#include "animation/script.h"
 #include "graphics/camera.h"
+#include "graphics/font.h"
+#include "graphics/pipeline_cache.h"
 #include "graphics/renderer.h"
 #include "graphics/text.h"
 #include "platform/glfw_wgpu_surface.h"
+#include "scene/preview.h"
+#include "scene/scene.h"
+#include "util/phase_timer.h"
+#include "util/profiler.h"
+#include "video/exporter.h"
+#include "video/render_farm.h"
 
 constexpr uint32_t windowWidth = 1280;
 constexpr uint32_t windowHeight = 720;
 
-int main()
+// previously seen preview frames are kept on the GPU at half resolution,
+// left / right scrub through the timeline and enter toggles playback
+constexpr uint32_t defaultCacheBudget = 512;
+constexpr float defaultCacheScale = 0.5f;
+
+constexpr const char* defaultScene = R"({
+  "texts": [{"text": "Hello, World!", "alignment": "centered"}],
+  "script": "hello"
+})";
+
+animation::Script helloScript(scene::Scene& scene)
 {
-  if (!glfwInit())
+  using namespace std::chrono_literals;
+
+  auto& text = *scene.texts().front();
+  co_await animation::play(animation::fadeIn(text), 1s);
+  co_await animation::wait(0.5s);
+  co_await animation::play(
+    animation::moveTo(text.transform, glm::vec3(0.0f, 0.5f, 0.0f)),
+    1s
+  );
+  co_await animation::play(
+    animation::colorTo(text, glm::vec3(1.0f, 0.6f, 0.2f)),
+    0.5s
+  );
+  co_await animation::wait(1.5s);
+  co_await animation::play(animation::fadeOut(text), 0.5s);
+}
+
+struct Options
+{
+  std::optional<std::filesystem::path> scenePath;
+  std::optional<std::filesystem::path> exportPath;
+  std::vector<std::filesystem::path> batchPaths;
+
+  std::optional<uint32_t> frameRate;
+  std::optional<uint32_t> frameCount;
+  uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+  std::optional<uint32_t> farmWorkerCount;
+  std::optional<std::filesystem::path> farmSocket;
+  std::optional<std::filesystem::path> farmWorkerSocket;
+  uint32_t chunkFrameCount = 60;
+  uint32_t chunkTimeout = 120;
+
+  uint32_t cacheBudget = defaultCacheBudget;
+  float cacheScale = defaultCacheScale;
+  bool continuous = false;
+  bool overlay = false;
+
+  std::optional<std::filesystem::path> tracePath;
+  uint64_t traceFirstFrame = 0;
+  uint64_t traceFrameCount = 300;
+
+  std::optional<std::filesystem::path> statsPath;
+
+  std::filesystem::path pipelineCachePath =
+    graphics::PipelineCache::defaultDirectory();
+  bool pipelineCache = true;
+};
+
+// Parses the value of a numeric option. Anything but a number in range of T
+// ends the program with an error, like any other invalid command line. No
+// option takes a negative number.
+template <typename T>
+T parseNumber(std::string_view option, const char* value)
+{
+  // unlike stoull and stod, from_chars neither skips whitespace nor accepts
+  // a sign for unsigned types
+  std::string_view text = value;
+  const char* last = text.data() + text.size();
+  T number{};
+  bool valid = false;
+
+  if constexpr (std::is_floating_point_v<T>)
+  {
+#if defined(__cpp_lib_to_chars)
+    auto [end, error] = std::from_chars(text.data(), last, number);
+    valid = error == std::errc() && end == last;
+#else
+    // standard libraries without floating point from_chars, strtod skips
+    // whitespace, so the number has to start right away
+    if (!text.empty() &&
+        (std::isdigit((unsigned char)text[0]) || text[0] == '.'))
+    {
+      char* end = nullptr;
+      number = (T)std::strtod(value, &end);
+      valid = end == last;
+    }
+#endif
+    valid = valid && std::isfinite(number) && number >= 0;
+  }
+  else
+  {
+    auto [end, error] = std::from_chars(text.data(), last, number);
+    valid = error == std::errc() && end == last;
+  }
+
+  if (!valid)
+  {
+    std::cerr << "[Options] Invalid value for " << option << ": " << value
+              << std::endl;
+    std::exit(1);
+  }
+  return number;
+}
+
+std::optional<Options> parseOptions(int argc, char** argv)
+{
+  Options options{};
+  for (int i = 1; i < argc; i++)
+  {
+    std::string_view argument = argv[i];
+    if (argument == "--scene" && i + 1 < argc)
+    {
+      options.scenePath = argv[++i];
+    }
+    else if (argument == "--export" && i + 1 < argc)
+    {
+      options.exportPath = argv[++i];
+    }
+    else if (argument == "--batch")
+    {
+      while (i + 1 < argc && std::string_view(argv[i + 1]).substr(0, 2) != "--")
+      {
+        options.batchPaths.emplace_back(argv[++i]);
+      }
+    }
+    else if (argument == "--frames" && i + 1 < argc)
+    {
+      options.frameCount = parseNumber<uint32_t>(argument, argv[++i]);
+    }
+    else if (argument == "--fps" && i + 1 < argc)
+    {
+      options.frameRate = parseNumber<uint32_t>(argument, argv[++i]);
+    }
+    else if (argument == "--threads" && i + 1 < argc)
+    {
+      options.threadCount =
+        std::max(parseNumber<uint32_t>(argument, argv[++i]), 1u);
+    }
+    else if (argument == "--farm" && i + 1 < argc)
+    {
+      options.farmWorkerCount = parseNumber<uint32_t>(argument, argv[++i]);
+    }
+    else if (argument == "--farm-socket" && i + 1 < argc)
+    {
+      options.farmSocket = argv[++i];
+    }
+    else if (argument == "--farm-worker" && i + 1 < argc)
+    {
+      options.farmWorkerSocket = argv[++i];
+    }
+    else if (argument == "--chunk-frames" && i + 1 < argc)
+    {
+      options.chunkFrameCount = parseNumber<uint32_t>(argument, argv[++i]);
+    }
+    else if (argument == "--chunk-timeout" && i + 1 < argc)
+    {
+      options.chunkTimeout = parseNumber<uint32_t>(argument, argv[++i]);
+    }
+    else if (argument == "--cache-budget" && i + 1 < argc)
+    {
+      options.cacheBudget = parseNumber<uint32_t>(argument, argv[++i]);
+    }
+    else if (argument == "--cache-scale" && i + 1 < argc)
+    {
+      options.cacheScale =
+        std::clamp(parseNumber<float>(argument, argv[++i]), 0.1f, 1.0f);
+    }
+    else if (argument == "--continuous")
+    {
+      options.continuous = true;
+    }
+    else if (argument == "--overlay")
+    {
+      options.overlay = true;
+    }
+    else if (argument == "--trace" && i + 1 < argc)
+    {
+      options.tracePath = argv[++i];
+    }
+    else if (argument == "--trace-first" && i + 1 < argc)
+    {
+      options.traceFirstFrame = parseNumber<uint64_t>(argument, argv[++i]);
+    }
+    else if (argument == "--trace-frames" && i + 1 < argc)
+    {
+      options.traceFrameCount = parseNumber<uint64_t>(argument, argv[++i]);
+    }
+    else if (argument == "--stats" && i + 1 < argc)
+    {
+      options.statsPath = argv[++i];
+    }
+    else if (argument == "--pipeline-cache" && i + 1 < argc)
+    {
+      options.pipelineCachePath = argv[++i];
+    }
+    else if (argument == "--no-pipeline-cache")
+    {
+      options.pipelineCache = false;
+    }
+    else
+    {
+      std::cerr << "Usage: tanim [--scene <file.json>] [--export <file.yuv>] "
+                   "[--frames <count>] [--fps <rate>]\n"
+                   "             [--threads <count>] [--farm <workers>] "
+                   "[--farm-socket <path>]\n"
+                   "             [--chunk-frames <count>] "
+                   "[--chunk-timeout <seconds>]\n"
+                   "             [--cache-budget <MiB>] "
+                   "[--cache-scale <factor>] [--continuous] [--overlay]\n"
+                   "             [--trace <trace.json>] "
+                   "[--trace-first <frame>] [--trace-frames <count>]\n"
+                   "             [--stats <stats.csv>] "
+                   "[--pipeline-cache <dir>] [--no-pipeline-cache]\n"
+                   "       tanim --batch <scene.json>... [--threads <count>]\n"
+                   "       tanim --farm-worker <socket> [--scene <file.json>] "
+                   "[--fps <rate>] [--threads <count>]"
+                << std::endl;
+      return std::nullopt;
+    }
+  }
+
+  if (options.farmWorkerCount && !options.exportPath)
+  {
+    std::cerr << "--farm requires --export" << std::endl;
+    return std::nullopt;
+  }
+
+  return options;
+}
+
+scene::SceneDescription loadScene(const Options& options)
+{
+  auto description =
+    options.scenePath
+      ? scene::SceneDescription::load(*options.scenePath)
+      : scene::SceneDescription::parse(nlohmann::json::parse(defaultScene));
+
+  if (options.frameRate)
+  {
+    description.frameRate = *options.frameRate;
+  }
+  if (options.frameCount)
+  {
+    description.frameCount = *options.frameCount;
+  }
+  return description;
+}
+
+// A font atlas being read and decoded on another thread
+struct PendingFont
+{
+  struct Decoded
+  {
+    graphics::FontData data;
+    double seconds;
+  };
+
+  std::filesystem::path path;
+  std::future<Decoded> decoded;
+};
+
+// Starts decoding the fonts of the scene, so file I/O and PNG decoding
+// overlap with the adapter and device requests.
+std::vector<PendingFont> decodeFonts(const Options& options)
+{
+  std::vector<std::filesystem::path> paths;
+  try
+  {
+    paths = loadScene(options).fonts();
+  }
+  catch (const std::exception&)
+  {
+    // reported once the scene is loaded for real
+  }
+
+  std::vector<PendingFont> fonts;
+  for (const auto& path : paths)
+  {
+    auto decoded = std::async(
+      std::launch::async,
+      [path]
+      {
+        auto start = std::chrono::steady_clock::now();
+        auto data = graphics::Font::decode(path);
+        return PendingFont::Decoded{
+          std::move(data),
+          std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+          )
+            .count(),
+        };
+      }
+    );
+    fonts.push_back({path, std::move(decoded)});
+  }
+  return fonts;
+}
+
+// Uploads the decoded fonts. Fonts which failed to decode are skipped, the
+// scene reports the error when it loads them itself.
+void addFonts(
+  graphics::Renderer& renderer,
+  std::vector<PendingFont>& fonts,
+  util::PhaseTimer& startup
+)
+{
+  double seconds = 0.0;
+  for (auto& font : fonts)
+  {
+    try
+    {
+      auto decoded = font.decoded.get();
+      seconds += decoded.seconds;
+      renderer.addFont(font.path, std::move(decoded.data));
+    }
+    catch (const std::exception&)
+    {
+    }
+  }
+  fonts.clear();
+
+  startup.mark("fonts");
+  startup.add("font decode", seconds);
+}
+
+// Prints the frame time percentiles of the latest frames and writes the
+// counters of every frame, if requested.
+void reportStats(graphics::RenderStats& stats, const Options& options)
+{
+  if (!options.statsPath)
+  {
+    return;
+  }
+
+  auto print = [](
+                 const char* name,
+                 const graphics::FrameTimeHistogram& times
+               )
+  {
+    std::cerr << "[Stats] " << name << " p50 " << times.percentile(0.50) * 1e3
+              << " ms, p95 " << times.percentile(0.95) * 1e3 << " ms, p99 "
+              << times.percentile(0.99) * 1e3 << " ms over the last "
+              << times.count() << " frames" << std::endl;
+  };
+
+  std::cerr << "[Stats] " << stats.frameCount() << " frames" << std::endl;
+  print("CPU", stats.cpuTimes());
+  if (stats.gpuTimes().count() > 0)
+  {
+    print("GPU", stats.gpuTimes());
+  }
+
+  stats.finishRecording();
+}
+
+// Splits the export across worker processes, which are this executable
+// started in --farm-worker mode. Runs without a GPU device of its own.
+int runFarm(const char* executable, const Options& options)
+{
+  auto description = loadScene(options);
+
+  uint32_t workerCount = std::max(*options.farmWorkerCount, 1u);
+
+  video::FarmOptions farmOptions{};
+  farmOptions.socketPath = options.farmSocket.value_or(
+    options.exportPath->string() + ".sock"
+  );
+  farmOptions.outputPath = *options.exportPath;
+  farmOptions.frameCount = description.frameCount;
+  farmOptions.chunkFrameCount = options.chunkFrameCount;
+  farmOptions.chunkTimeout = std::chrono::seconds(options.chunkTimeout);
+  farmOptions.workerCount = *options.farmWorkerCount;
+  farmOptions.workerCommand = {
+    executable,
+    "--fps",
+    std::to_string(description.frameRate),
+    "--threads",
+    std::to_string(std::max(options.threadCount / workerCount, 1u)),
+  };
+  if (options.scenePath)
+  {
+    farmOptions.workerCommand.push_back("--scene");
+    farmOptions.workerCommand.push_back(options.scenePath->string());
+  }
+
+  // workers share the pipeline cache, entries are written atomically
+  if (options.pipelineCache)
+  {
+    farmOptions.workerCommand.push_back("--pipeline-cache");
+    farmOptions.workerCommand.push_back(options.pipelineCachePath.string());
+  }
+  else
+  {
+    farmOptions.workerCommand.push_back("--no-pipeline-cache");
+  }
+
+  auto coordinator = video::FarmCoordinator(farmOptions);
+  return coordinator.run();
+}
+
+// Offline rendering: single exports, farm workers and batches. All scenes of
+// a batch share the device, renderer, pipelines and font cache, so startup
+// is only paid once.
+int runExport(
+  const wgpu::Instance& instance,
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  const Options& options,
+  std::vector<PendingFont>& fonts,
+  util::PhaseTimer& startup
+)
+{
+  auto renderer = graphics::Renderer(device, queue, video::Exporter::format);
+  if (options.statsPath)
+  {
+    renderer.stats().record(*options.statsPath);
+  }
+  auto exporter =
+    video::Exporter(instance, device, queue, renderer, options.threadCount);
+  startup.mark("renderer");
+
+  addFonts(renderer, fonts, startup);
+
+  renderer.waitForPipelines();
+  startup.mark("pipelines");
+  startup.report();
+
+  auto exportScene = [&](
+                       const scene::SceneDescription& description,
+                       uint64_t firstFrame,
+                       uint64_t frameCount,
+                       const std::filesystem::path& path
+                     )
+  {
+    // offline export runs as fast as the GPU allows, the fixed step clock
+    // keeps every frame time exact regardless of how long a frame took
+    auto clock = animation::Clock::fixedStep(description.frameRate);
+    return exporter.render(
+      [&] { return std::make_unique<scene::Scene>(description, renderer); },
+      clock,
+      firstFrame,
+      frameCount,
+      description.width,
+      description.height,
+      path
+    );
+  };
+
+  if (!options.batchPaths.empty())
+  {
+    bool succeeded = true;
+    for (const auto& path : options.batchPaths)
+    {
+      try
+      {
+        auto description = scene::SceneDescription::load(path);
+        std::cout << "[Batch] " << path.string() << " -> "
+                  << description.output.string() << std::endl;
+        succeeded &= exportScene(
+          description,
+          0,
+          description.frameCount,
+          description.output
+        );
+      }
+      catch (const std::exception& exception)
+      {
+        std::cerr << "[Batch] " << path.string() << ": " << exception.what()
+                  << std::endl;
+        succeeded = false;
+      }
+    }
+    reportStats(renderer.stats(), options);
+    return succeeded ? 0 : 1;
+  }
+
+  auto description = loadScene(options);
+
+  if (options.farmWorkerSocket)
+  {
+    int result = video::runFarmWorker(
+      *options.farmWorkerSocket,
+      [&](
+        uint64_t firstFrame,
+        uint64_t frameCount,
+        const std::filesystem::path& path
+      ) { return exportScene(description, firstFrame, frameCount, path); }
+    );
+    reportStats(renderer.stats(), options);
+    return result;
+  }
+
+  bool succeeded = exportScene(
+    description,
+    0,
+    description.frameCount,
+    *options.exportPath
+  );
+  reportStats(renderer.stats(), options);
+  return succeeded ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+  util::PhaseTimer startup("Startup");
+
+  auto options = parseOptions(argc, argv);
+  if (!options)
   {
-    std::cerr << "[GLFW] Could not initialize GLFW" << std::endl;
     return 1;
   }
 
-  glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-  GLFWwindow* window =
-    glfwCreateWindow(windowWidth, windowHeight, "Animation", nullptr, nullptr);
-  if (!window)
+  scene::registerScript("hello", helloScript);
+
+  if (options->farmWorkerCount && !options->farmWorkerSocket)
+  {
+    return runFarm(argv[0], *options);
+  }
+
+  auto fonts = decodeFonts(*options);
+
+  bool headless = options->exportPath || options->farmWorkerSocket ||
+                  !options->batchPaths.empty();
+  if (!headless && !glfwInit())
   {
-    std::cerr << "[GLFW] Could not create Window" << std::endl;
-    glfwTerminate();
+    std::cerr << "[GLFW] Could not initialize GLFW" << std::endl;
     return 1;
   }
+  startup.mark("glfw");
 
   wgpu::InstanceDescriptor instanceDescriptor{};
   instanceDescriptor.features.timedWaitAnyEnable = true;
@@ -45,40 +581,79 @@ int main()
     std::cerr << "[WebGPU] Could not create Instance" << std::endl;
     return 1;
   }
+  startup.mark("instance");
 
   wgpu::RequestAdapterOptions adapterOptions{};
 
+  // the window is created while the adapter request is pending
   wgpu::Adapter adapter;
-  instance.WaitAny(
-    instance.RequestAdapter(
-      &adapterOptions,
-      wgpu::CallbackMode::WaitAnyOnly,
-      [](
-        wgpu::RequestAdapterStatus status,
-        wgpu::Adapter adapter,
-        wgpu::StringView message,
-        wgpu::Adapter* outAdapter
-      )
+  auto adapterFuture = instance.RequestAdapter(
+    &adapterOptions,
+    wgpu::CallbackMode::WaitAnyOnly,
+    [](
+      wgpu::RequestAdapterStatus status,
+      wgpu::Adapter adapter,
+      wgpu::StringView message,
+      wgpu::Adapter* outAdapter
+    )
+    {
+      *outAdapter = adapter;
+      if (!adapter)
       {
-        *outAdapter = adapter;
-        if (!adapter)
-        {
-          std::cerr << "[WebGPU] Failed to get Adapter: " << message
-                    << std::endl;
-        }
-      },
-      &adapter
-    ),
-    UINT64_MAX
+        std::cerr << "[WebGPU] Failed to get Adapter: " << message
+                  << std::endl;
+      }
+    },
+    &adapter
   );
+
+  GLFWwindow* window = nullptr;
+  wgpu::Surface surface;
+  if (!headless)
+  {
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    window = glfwCreateWindow(
+      windowWidth,
+      windowHeight,
+      "Animation",
+      nullptr,
+      nullptr
+    );
+    if (!window)
+    {
+      std::cerr << "[GLFW] Could not create Window" << std::endl;
+      glfwTerminate();
+      return 1;
+    }
+
+    surface = platform::glfwCreateWGPUSurface(instance, window);
+    if (!surface)
+    {
+      std::cerr << "[WebGPU] Could not create Surface" << std::endl;
+      return 1;
+    }
+    startup.mark("window");
+  }
+
+  instance.WaitAny(adapterFuture, UINT64_MAX);
   if (!adapter)
   {
     std::cerr << "[WebGPU] Could not request Adapter" << std::endl;
     return 1;
   }
+  startup.mark("adapter");
+
+  // optional, the renderer only measures GPU pass timings with it
+  std::vector<wgpu::FeatureName> requiredFeatures;
+  if (adapter.HasFeature(wgpu::FeatureName::TimestampQuery))
+  {
+    requiredFeatures.push_back(wgpu::FeatureName::TimestampQuery);
+  }
 
   wgpu::DeviceDescriptor deviceDescriptor{};
   deviceDescriptor.label = "Device";
+  deviceDescriptor.requiredFeatureCount = requiredFeatures.size();
+  deviceDescriptor.requiredFeatures = requiredFeatures.data();
   deviceDescriptor.defaultQueue.label = "Default Queue";
   deviceDescriptor.SetDeviceLostCallback(
     wgpu::CallbackMode::WaitAnyOnly,
@@ -104,6 +679,16 @@ int main()
     }
   );
 
+  // has to outlive the device, Dawn stores compiled pipelines until the end
+  auto pipelineCache = graphics::PipelineCache(
+    options->pipelineCachePath,
+    graphics::PipelineCache::defaultBudget
+  );
+  if (options->pipelineCache)
+  {
+    pipelineCache.attach(deviceDescriptor, adapter);
+  }
+
   wgpu::Device device;
   instance.WaitAny(
     adapter.RequestDevice(
@@ -127,14 +712,31 @@ int main()
     ),
     UINT64_MAX
   );
+  startup.mark("device");
 
   auto queue = device.GetQueue();
 
-  auto surface = platform::glfwCreateWGPUSurface(instance, window);
-  if (!surface)
+  if (options->tracePath)
   {
-    std::cerr << "[WebGPU] Could not create Surface" << std::endl;
-    return 1;
+#ifndef TANIM_PROFILE
+    std::cerr << "[Profiler] Built without TANIM_PROFILE, the trace will be "
+                 "empty"
+              << std::endl;
+#endif
+    util::Profiler::capture(options->traceFirstFrame, options->traceFrameCount);
+    TANIM_PROFILE_THREAD("Main");
+  }
+
+  if (headless)
+  {
+    int result =
+      runExport(instance, device, queue, *options, fonts, startup);
+    pipelineCache.report();
+    if (options->tracePath)
+    {
+      util::Profiler::writeTrace(*options->tracePath);
+    }
+    return result;
   }
 
   wgpu::SurfaceCapabilities surfaceCapabilities;
@@ -151,25 +753,130 @@ int main()
   surfaceConfig.presentMode = wgpu::PresentMode::Fifo;
   surfaceConfig.alphaMode = wgpu::CompositeAlphaMode::Auto;
   surface.Configure(&surfaceConfig);
+  startup.mark("surface");
 
   auto renderer = graphics::Renderer(device, queue, surfaceFormat);
+  if (options->statsPath)
+  {
+    renderer.stats().record(*options->statsPath);
+  }
+  startup.mark("renderer");
+
+  addFonts(renderer, fonts, startup);
+
+  auto description = loadScene(*options);
+  auto scene = scene::Scene(description, renderer);
+  startup.mark("scene");
+
+  auto clock = animation::Clock::realTime(description.frameRate);
+
+  scene::PreviewSettings previewSettings{};
+  previewSettings.width = windowWidth;
+  previewSettings.height = windowHeight;
+  previewSettings.format = surfaceFormat;
+  previewSettings.cacheBudget = (size_t)options->cacheBudget * 1024 * 1024;
+  previewSettings.cacheScale = options->cacheScale;
+  previewSettings.continuous = options->continuous;
+  previewSettings.overlay = options->overlay;
+  auto preview = scene::Preview(
+    device,
+    queue,
+    renderer,
+    scene,
+    clock,
+    description.frameCount,
+    previewSettings
+  );
+  startup.mark("resources");
+
+  renderer.waitForPipelines();
+  startup.mark("pipelines");
+  bool started = false;
 
-  auto& font = renderer.font("assets/fonts/ARIALBD.TTF-msdf");
+  // playback starts with the first frame, not when the clock was created
+  clock.seek(0);
 
-  auto text = graphics::Text("Hello, World!", font);
-  text.setAlignment(graphics::TextAlignment::Centered);
+  // space shatters the texts, enter toggles playback, left / right scrub
+  // through the timeline and F3 toggles the performance overlay
+  bool shatterPressed = false;
+  bool togglePressed = false;
+  bool overlayPressed = false;
+  bool idle = false;
 
-  auto camera = graphics::Camera();
+  // the profiler counts loop iterations, the clock restarts whenever the
+  // preview loops or playback resumes
+  uint64_t loopIteration = 0;
 
-  float time = 0.0f;
+  // the window system asks for a redraw when the contents got lost
+  glfwSetWindowUserPointer(window, &preview);
+  glfwSetWindowRefreshCallback(
+    window,
+    [](GLFWwindow* window)
+    {
+      auto* preview = (scene::Preview*)glfwGetWindowUserPointer(window);
+      preview->expose();
+    }
+  );
 
   while (!glfwWindowShouldClose(window))
   {
-    glfwPollEvents();
+    if (!idle)
+    {
+      glfwPollEvents();
+    }
+    else if (std::isinf(preview.idleTimeout()))
+    {
+      glfwWaitEvents();
+    }
+    else
+    {
+      glfwWaitEventsTimeout(std::max(preview.idleTimeout(), 0.0));
+    }
+
+    util::Profiler::beginFrame(loopIteration++);
+    if (options->tracePath && util::Profiler::finished())
+    {
+      util::Profiler::writeTrace(*options->tracePath);
+      options->tracePath.reset();
+    }
+    TANIM_PROFILE_ZONE("Frame");
+
+    // frame times exclude the idle wait above
+    auto frameStart = std::chrono::steady_clock::now();
+
+    bool shatter = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    if (shatter && !shatterPressed)
+    {
+      preview.shatter();
+    }
+    shatterPressed = shatter;
+
+    bool toggle = glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS;
+    if (toggle && !togglePressed)
+    {
+      preview.togglePlayback();
+    }
+    togglePressed = toggle;
+
+    bool overlayKey = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+    if (overlayKey && !overlayPressed)
+    {
+      preview.toggleOverlay();
+    }
+    overlayPressed = overlayKey;
 
-    float newTime = (float)glfwGetTime();
-    float deltaTime = newTime - time;
-    time = newTime;
+    bool left = glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS;
+    bool right = glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS;
+    if (left || right)
+    {
+      preview.step(right);
+    }
+
+    idle = !preview.update();
+    if (idle)
+    {
+      continue;
+    }
 
     wgpu::SurfaceTexture surfaceTexture;
     surface.GetCurrentTexture(&surfaceTexture);
@@ -185,11 +892,36 @@ int main()
     auto surfaceView =
       surfaceTexture.texture.CreateView(&textureViewDescriptor);
 
-    renderer.drawText(text, camera);
-    renderer.flush(surfaceView);
-
+    preview.draw(surfaceView);
     surface.Present();
+
+    // completes the timestamp readbacks, so the GPU timer reuses its slots
+    instance.ProcessEvents();
+
+    renderer.stats().endFrame(
+      preview.frameIndex(),
+      std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - frameStart
+      )
+        .count()
+    );
+
+    if (!started)
+    {
+      startup.mark("first frame");
+      startup.report();
+      pipelineCache.report();
+      started = true;
+    }
   }
+
+  // the window was closed before the capture range ended
+  if (options->tracePath)
+  {
+    util::Profiler::writeTrace(*options->tracePath);
+  }
+
+  reportStats(renderer.stats(), *options);
 }
 
 #ifdef _WIN32
@@ -209,7 +941,7 @@ int WINAPI WinMain(
     freopen_s(&pStdout, "CONOUT$", "w", stdout);
     freopen_s(&pStderr, "CONOUT$", "w", stderr);
   }
-  return main();
+  return main(__argc, __argv);
 }
 
 #endif
@@ -0,0 +1,194 @@
+#include "preview.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "util/profiler.h"
+
+namespace scene
+{
+// pressing space in the preview shatters the texts into particles
+constexpr uint32_t particleCapacity = 128 * 1024;
+constexpr uint32_t particleCopies = 64;
+
+Preview::Preview(
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  graphics::Renderer& renderer,
+  Scene& scene,
+  animation::Clock& clock,
+  uint64_t frameCount,
+  const PreviewSettings& settings
+)
+  : _renderer(renderer),
+    _scene(scene),
+    _clock(clock),
+    _frameCount(std::max<uint64_t>(frameCount, 1)),
+    _particles(device, queue, renderer, particleCapacity),
+    _cache(
+      device,
+      queue,
+      settings.format,
+      settings.width,
+      settings.height,
+      settings.cacheScale,
+      settings.cacheBudget
+    ),
+    _overlay(renderer, settings.width, settings.height),
+    _showOverlay(settings.overlay),
+    _renderedRevision(scene.revision()),
+    _continuous(settings.continuous)
+{
+  wgpu::TextureDescriptor targetDescriptor{};
+  targetDescriptor.label = "Preview Target Texture";
+  targetDescriptor.dimension = wgpu::TextureDimension::e2D;
+  targetDescriptor.size = {settings.width, settings.height, 1};
+  targetDescriptor.mipLevelCount = 1;
+  targetDescriptor.sampleCount = 1;
+  targetDescriptor.format = settings.format;
+  targetDescriptor.usage =
+    wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding;
+  _target = device.CreateTexture(&targetDescriptor);
+  _targetView = _target.CreateView();
+}
+
+void Preview::togglePlayback()
+{
+  _playing = !_playing;
+  if (_playing)
+  {
+    _clock.seek(_frameIndex);
+  }
+}
+
+void Preview::step(bool forward)
+{
+  _playing = false;
+  _frameIndex = forward ? std::min(_frameIndex + 1, _frameCount - 1)
+                        : (_frameIndex > 0 ? _frameIndex - 1 : 0);
+}
+
+void Preview::toggleOverlay()
+{
+  _showOverlay = !_showOverlay;
+  _exposed = true;
+}
+
+void Preview::shatter()
+{
+  graphics::ParticleEmitSettings settings{};
+  settings.copies = particleCopies;
+  for (auto& text : _scene.texts())
+  {
+    _particles.emit(*text, settings);
+  }
+}
+
+bool Preview::update()
+{
+  _clock.tick();
+  _particles.update((float)_clock.deltaTime());
+
+  // expired particles are still in the target and on the surface
+  if (_particlesShown && cacheable())
+  {
+    _renderedFrame.reset();
+    _presentedFrame.reset();
+  }
+  _particlesShown = !cacheable();
+
+  // the preview loops over the scene, later passes are served from the
+  // frame cache
+  if (_playing)
+  {
+    _frameIndex = (uint64_t)(_clock.time() * _clock.frameRate());
+    if (_frameIndex >= _frameCount)
+    {
+      _frameIndex %= _frameCount;
+      _clock.seek(_frameIndex);
+    }
+  }
+
+  double time = _clock.frameTime(_frameIndex);
+
+  // modifications outside of the timeline damage every rendered frame
+  if (_scene.revision() != _renderedRevision)
+  {
+    _cache.clear();
+    _renderedFrame.reset();
+    _presentedFrame.reset();
+    _renderedRevision = _scene.revision();
+  }
+
+  bool idle = !_continuous && !_exposed && cacheable() && _presentedFrame &&
+              !_scene.changes(_clock.frameTime(*_presentedFrame), time);
+  if (idle)
+  {
+    // wake up for the first frame after the next change, or the loop
+    double deadline = std::min(
+      _scene.nextChange(time),
+      _clock.frameTime(_frameCount)
+    );
+    deadline = std::max(deadline, _clock.frameTime(_frameIndex + 1));
+    _idleTimeout = _playing ? deadline - _clock.time()
+                            : std::numeric_limits<double>::infinity();
+    return false;
+  }
+
+  _exposed = false;
+  _presentedFrame = _frameIndex;
+  return true;
+}
+
+void Preview::draw(const wgpu::TextureView& target)
+{
+  TANIM_PROFILE_ZONE("Preview::draw");
+
+  double time = _clock.frameTime(_frameIndex);
+
+  // during holds the last rendered frame is still in the target
+  bool hold = cacheable() && _renderedFrame &&
+              !_scene.changes(_clock.frameTime(*_renderedFrame), time);
+  if (hold)
+  {
+    _cache.blit(_targetView, target);
+    drawOverlay(target);
+    return;
+  }
+
+  if (cacheable() && _cache.present(_frameIndex, target))
+  {
+    drawOverlay(target);
+    return;
+  }
+
+  _frame.reset(_frameIndex, time);
+  _scene.evaluate(time, _frame);
+
+  _renderer.drawFrame(_frame);
+  _particles.draw(_renderer);
+  _renderer.flush(_targetView);
+  _renderedFrame = _frameIndex;
+  _renderedRevision = _scene.revision();
+
+  if (cacheable())
+  {
+    _cache.store(_frameIndex, _targetView);
+  }
+  _cache.blit(_targetView, target);
+
+  drawOverlay(target);
+}
+
+void Preview::drawOverlay(const wgpu::TextureView& target)
+{
+  if (!_showOverlay)
+  {
+    return;
+  }
+
+  _overlay.update(_renderer.stats(), _cache.memoryUsage());
+  _overlay.draw(_renderer);
+  _renderer.flush(target, wgpu::LoadOp::Load);
+}
+}  // namespace scene
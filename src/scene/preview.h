@@ -0,0 +1,139 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "animation/clock.h"
+#include "graphics/frame_cache.h"
+#include "graphics/frame_data.h"
+#include "graphics/particle_system.h"
+#include "graphics/perf_overlay.h"
+#include "graphics/renderer.h"
+#include "scene/scene.h"
+
+namespace scene
+{
+struct PreviewSettings
+{
+  uint32_t width = 1280;
+  uint32_t height = 720;
+  wgpu::TextureFormat format = wgpu::TextureFormat::BGRA8Unorm;
+
+  // frame cache budget in bytes and resolution relative to the window
+  size_t cacheBudget = 512ull * 1024 * 1024;
+  float cacheScale = 0.5f;
+
+  // presents every frame instead of idling while nothing changes
+  bool continuous = false;
+  bool overlay = false;
+};
+
+// Per frame logic of the interactive preview, without the window system:
+// playback looping over the scene, scrubbing, the frame cache, idling while
+// the visible frame does not change, particles and the performance overlay.
+//
+// The front-end forwards input, calls update once per loop iteration and,
+// if it returned true, draws onto the surface and presents it. Otherwise it
+// waits for input, at most idleTimeout seconds.
+class Preview
+{
+ public:
+  Preview(
+    const wgpu::Device& device,
+    const wgpu::Queue& queue,
+    graphics::Renderer& renderer,
+    Scene& scene,
+    animation::Clock& clock,
+    uint64_t frameCount,
+    const PreviewSettings& settings
+  );
+  ~Preview() = default;
+
+  Preview(const Preview&) = delete;
+  Preview& operator=(const Preview&) = delete;
+
+  void togglePlayback();
+
+  // stops playback and moves one frame forward or back
+  void step(bool forward);
+
+  void toggleOverlay();
+
+  // shatters the texts into particles
+  void shatter();
+
+  // the window system lost the contents, the next frame is presented anyway
+  void expose()
+  {
+    _exposed = true;
+  }
+
+  // advances the clock and picks the frame to show, false if it is on the
+  // surface already
+  bool update();
+
+  // seconds until the visible frame changes, infinity while paused
+  double idleTimeout() const
+  {
+    return _idleTimeout;
+  }
+
+  // renders the frame, or copies it from the cache, onto the target
+  void draw(const wgpu::TextureView& target);
+
+  uint64_t frameIndex() const
+  {
+    return _frameIndex;
+  }
+
+  const graphics::FrameCache& cache() const
+  {
+    return _cache;
+  }
+
+ private:
+  // particles are simulated in real time and not part of the timeline, so
+  // frames showing them are neither cached nor served from the cache. They
+  // expire after a few seconds, then the cache is used again.
+  bool cacheable() const
+  {
+    return _particles.count() == 0;
+  }
+
+  void drawOverlay(const wgpu::TextureView& target);
+
+ private:
+  graphics::Renderer& _renderer;
+  Scene& _scene;
+  animation::Clock& _clock;
+  uint64_t _frameCount;
+
+  graphics::FrameData _frame;
+  graphics::ParticleSystem _particles;
+  bool _particlesShown = false;
+
+  // the scene is rendered into an offscreen target, so it can be copied
+  // into the frame cache as well as onto the surface
+  wgpu::Texture _target;
+  wgpu::TextureView _targetView;
+  graphics::FrameCache _cache;
+
+  // drawn onto the surface and never into the cached frames
+  graphics::PerfOverlay _overlay;
+  bool _showOverlay;
+
+  uint64_t _frameIndex = 0;
+  bool _playing = true;
+  std::optional<uint64_t> _renderedFrame;
+  uint64_t _renderedRevision;
+
+  // by default only frames differing from the presented one are presented
+  bool _continuous;
+  bool _exposed = true;
+  std::optional<uint64_t> _presentedFrame;
+  double _idleTimeout = 0.0;
+};
+}  // namespace scene
@@ -0,0 +1,607 @@
+#include "scene.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#include "util/profiler.h"
+
+namespace scene
+{
+constexpr const char* defaultFont = graphics::Renderer::defaultFont;
+
+static std::map<std::string, ScriptFactory>& scriptRegistry()
+{
+  static std::map<std::string, ScriptFactory> registry;
+  return registry;
+}
+
+void registerScript(const std::string& name, ScriptFactory factory)
+{
+  scriptRegistry()[name] = std::move(factory);
+}
+
+static glm::vec3 readVec3(
+  const nlohmann::json& json,
+  const char* key,
+  const glm::vec3& fallback
+)
+{
+  if (!json.contains(key))
+  {
+    return fallback;
+  }
+
+  const auto& value = json[key];
+  return glm::vec3(value.at(0), value.at(1), value.at(2));
+}
+
+static graphics::TextAlignment readAlignment(const nlohmann::json& json)
+{
+  auto alignment = json.value("alignment", std::string("left"));
+  if (alignment == "centered")
+  {
+    return graphics::TextAlignment::Centered;
+  }
+  else if (alignment == "right")
+  {
+    return graphics::TextAlignment::Right;
+  }
+  return graphics::TextAlignment::Left;
+}
+
+static animation::Easing readEasing(const nlohmann::json& json)
+{
+  auto easing = json.value("easing", std::string("linear"));
+  if (easing == "step")
+  {
+    return animation::Easing::Step;
+  }
+  else if (easing == "easeIn")
+  {
+    return animation::Easing::EaseIn;
+  }
+  else if (easing == "easeOut")
+  {
+    return animation::Easing::EaseOut;
+  }
+  else if (easing == "easeInOut")
+  {
+    return animation::Easing::EaseInOut;
+  }
+  return animation::Easing::Linear;
+}
+
+// {"type": "wave", "start": 0, "stagger": 0.05, "duration": 0.5, ...}
+static graphics::GlyphEffect readEffect(const nlohmann::json& json)
+{
+  graphics::GlyphEffect effect{};
+  auto type = json.value("type", std::string("none"));
+  if (type == "typewriter")
+  {
+    effect.type = graphics::GlyphEffectType::Typewriter;
+  }
+  else if (type == "fade")
+  {
+    effect.type = graphics::GlyphEffectType::Fade;
+  }
+  else if (type == "scaleIn")
+  {
+    effect.type = graphics::GlyphEffectType::ScaleIn;
+  }
+  else if (type == "wave")
+  {
+    effect.type = graphics::GlyphEffectType::Wave;
+  }
+
+  effect.startTime = json.value("start", effect.startTime);
+  effect.stagger = json.value("stagger", effect.stagger);
+  effect.duration = json.value("duration", effect.duration);
+  effect.amplitude = json.value("amplitude", effect.amplitude);
+  if (json.contains("easing"))
+  {
+    effect.easing = readEasing(json);
+  }
+  return effect;
+}
+
+// glyph effects are evaluated on the GPU from the frame time, waves keep
+// moving once they started
+static float effectDuration(const graphics::Text& text)
+{
+  const auto& effect = text.effect();
+  switch (effect.type)
+  {
+    case graphics::GlyphEffectType::None:
+      return 0.0f;
+
+    case graphics::GlyphEffectType::Wave:
+      return std::numeric_limits<float>::infinity();
+
+    default:
+      return effect.stagger * (float)text.characters().size() +
+             effect.duration;
+  }
+}
+
+SceneDescription SceneDescription::load(const std::filesystem::path& path)
+{
+  std::ifstream file(path);
+  if (!file.is_open())
+  {
+    throw std::runtime_error("Could not open " + path.string());
+  }
+
+  auto description = parse(nlohmann::json::parse(file));
+  if (description.output.empty())
+  {
+    description.output = std::filesystem::path(path).replace_extension(".yuv");
+  }
+  return description;
+}
+
+SceneDescription SceneDescription::parse(nlohmann::json json)
+{
+  SceneDescription description{};
+  description.output = json.value("output", std::string());
+  description.width = json.value("width", description.width);
+  description.height = json.value("height", description.height);
+  description.frameRate = json.value("fps", description.frameRate);
+
+  if (json.contains("frames"))
+  {
+    description.frameCount = json["frames"];
+  }
+  else
+  {
+    // without an explicit length the scene ends with its last keyframe
+    double duration = 0.0;
+    if (json.contains("animations"))
+    {
+      for (const auto& animation : json["animations"])
+      {
+        for (const auto& key : animation["keys"])
+        {
+          duration = std::max(duration, key.value("time", 0.0));
+        }
+      }
+    }
+
+    duration = json.value("duration", duration > 0.0 ? duration : 5.0);
+    description.frameCount = (uint64_t)(duration * description.frameRate);
+  }
+
+  description.json = std::move(json);
+  return description;
+}
+
+std::vector<std::filesystem::path> SceneDescription::fonts() const
+{
+  std::vector<std::filesystem::path> fonts;
+  for (const char* key : {"texts", "numbers"})
+  {
+    for (const auto& t : json.value(key, nlohmann::json::array()))
+    {
+      std::filesystem::path font = t.value("font", std::string(defaultFont));
+      if (std::find(fonts.begin(), fonts.end(), font) == fonts.end())
+      {
+        fonts.push_back(font);
+      }
+    }
+  }
+  return fonts;
+}
+
+Scene::Scene(const SceneDescription& description, graphics::Renderer& renderer)
+{
+  const auto& json = description.json;
+
+  _camera.setAspect((float)description.width / (float)description.height);
+  if (json.contains("camera"))
+  {
+    const auto& camera = json["camera"];
+    _camera.setPosition(readVec3(camera, "position", _camera.position()));
+    _camera.setFov(glm::radians(camera.value("fov", 45.0f)));
+  }
+
+  for (const auto& t : json.value("texts", nlohmann::json::array()))
+  {
+    std::filesystem::path fontPath = t.value("font", std::string(defaultFont));
+    auto& font = renderer.font(fontPath);
+
+    auto& text = *_texts.emplace_back(
+      std::make_unique<graphics::Text>(t.value("text", std::string()), font)
+    );
+    text.setAlignment(readAlignment(t));
+    text.setColor(readVec3(t, "color", text.color()));
+    text.transform.setPosition(readVec3(t, "position", glm::vec3(0.0f)));
+    text.transform.setRotation(
+      glm::quat(glm::radians(readVec3(t, "rotation", glm::vec3(0.0f))))
+    );
+    text.transform.setScale(readVec3(t, "scale", glm::vec3(1.0f)));
+    if (t.contains("effect"))
+    {
+      text.setEffect(readEffect(t["effect"]));
+    }
+    if (t.contains("write"))
+    {
+      addWrite(t["write"], _texts.size() - 1, fontPath, renderer);
+    }
+  }
+
+  for (const auto& n : json.value("numbers", nlohmann::json::array()))
+  {
+    auto& font = renderer.font(n.value("font", std::string(defaultFont)));
+
+    auto& number = *_numbers.emplace_back(
+      std::make_unique<graphics::NumberText>(
+        font,
+        n.value("decimals", 0u),
+        n.value("separators", true)
+      )
+    );
+    number.setValue(n.value("value", 0.0));
+    number.setAlignment(readAlignment(n));
+    number.setColor(readVec3(n, "color", number.color()));
+    number.transform.setPosition(readVec3(n, "position", glm::vec3(0.0f)));
+    number.transform.setRotation(
+      glm::quat(glm::radians(readVec3(n, "rotation", glm::vec3(0.0f))))
+    );
+    number.transform.setScale(readVec3(n, "scale", glm::vec3(1.0f)));
+  }
+
+  if (json.contains("animations"))
+  {
+    for (const auto& animation : json["animations"])
+    {
+      addAnimation(animation);
+    }
+  }
+
+  // morphs capture the text layouts before any animation is applied
+  if (json.contains("morphs"))
+  {
+    for (const auto& morph : json["morphs"])
+    {
+      addMorph(morph, renderer);
+    }
+  }
+
+  if (json.contains("script"))
+  {
+    std::string name = json["script"];
+    auto it = scriptRegistry().find(name);
+    if (it == scriptRegistry().end())
+    {
+      throw std::runtime_error("Unknown script: " + name);
+    }
+    _scheduler.spawn(it->second, *this);
+  }
+}
+
+// {"text": 0, "property": "position", "keys": [{"time": 0, "value": [..]}]}
+// {"camera": true, "property": "fov", "keys": [{"time": 0, "value": 45}]}
+// {"number": 0, "property": "value", "keys": [{"time": 0, "value": 1000}]}
+// rotations and the field of view are given in degrees
+void Scene::addAnimation(const nlohmann::json& json)
+{
+  using animation::TrackProperty;
+
+  auto property = json.value("property", std::string());
+
+  size_t track;
+  if (json.value("camera", false))
+  {
+    if (property == "position")
+    {
+      track = _timeline.track(_camera, TrackProperty::CameraPosition);
+    }
+    else if (property == "rotation")
+    {
+      track = _timeline.track(_camera, TrackProperty::CameraRotation);
+    }
+    else if (property == "fov")
+    {
+      track = _timeline.track(_camera, TrackProperty::CameraFov);
+    }
+    else
+    {
+      throw std::runtime_error("Unknown camera property: " + property);
+    }
+  }
+  else if (json.contains("number"))
+  {
+    auto& number = *_numbers.at(json.value("number", 0));
+    if (property == "value")
+    {
+      track = _timeline.track(number, TrackProperty::Value);
+    }
+    else if (property == "position")
+    {
+      track = _timeline.track(number.transform, TrackProperty::Position);
+    }
+    else if (property == "rotation")
+    {
+      track = _timeline.track(number.transform, TrackProperty::Rotation);
+    }
+    else if (property == "scale")
+    {
+      track = _timeline.track(number.transform, TrackProperty::Scale);
+    }
+    else
+    {
+      throw std::runtime_error("Unknown number property: " + property);
+    }
+  }
+  else
+  {
+    auto& text = *_texts.at(json.value("text", 0));
+    if (property == "position")
+    {
+      track = _timeline.track(text.transform, TrackProperty::Position);
+    }
+    else if (property == "rotation")
+    {
+      track = _timeline.track(text.transform, TrackProperty::Rotation);
+    }
+    else if (property == "scale")
+    {
+      track = _timeline.track(text.transform, TrackProperty::Scale);
+    }
+    else if (property == "color")
+    {
+      track = _timeline.track(text, TrackProperty::Color);
+    }
+    else if (property == "opacity")
+    {
+      track = _timeline.track(text, TrackProperty::Opacity);
+    }
+    else
+    {
+      throw std::runtime_error("Unknown text property: " + property);
+    }
+  }
+
+  for (const auto& key : json["keys"])
+  {
+    float time = key.value("time", 0.0f);
+    auto easing = readEasing(key);
+
+    if (property == "rotation")
+    {
+      auto angles = readVec3(key, "value", glm::vec3(0.0f));
+      _timeline.addKey(track, time, glm::quat(glm::radians(angles)), easing);
+    }
+    else if (property == "opacity" || property == "value")
+    {
+      _timeline.addKey(track, time, key.value("value", 1.0f), easing);
+    }
+    else if (property == "fov")
+    {
+      float fov = glm::radians(key.value("value", 45.0f));
+      _timeline.addKey(track, time, fov, easing);
+    }
+    else
+    {
+      auto value = readVec3(key, "value", glm::vec3(0.0f));
+      _timeline.addKey(track, time, value, easing);
+    }
+  }
+}
+
+// {"from": 0, "to": 1, "start": 1.0, "duration": 1.0, "easing": "easeInOut"}
+void Scene::addMorph(const nlohmann::json& json, graphics::Renderer& renderer)
+{
+  size_t from = json.value("from", (size_t)0);
+  size_t to = json.value("to", (size_t)0);
+  if (from >= _texts.size() || to >= _texts.size())
+  {
+    throw std::runtime_error("Morph references a missing text");
+  }
+
+  auto& morph = _morphs.emplace_back();
+  morph.from = from;
+  morph.to = to;
+  morph.startTime = json.value("start", 0.0f);
+  morph.duration = std::max(json.value("duration", 1.0f), 1e-3f);
+  morph.easing = json.contains("easing") ? readEasing(json)
+                                         : animation::Easing::EaseInOut;
+  morph.morph = std::make_unique<graphics::TextMorph>(
+    renderer.device(),
+    renderer.queue(),
+    renderer,
+    *_texts[from],
+    *_texts[to]
+  );
+}
+
+// {"start": 0, "duration": 2, "thickness": 0.01, "outline": "font.ttf"}
+// the outline font defaults to the msdf font path without "-msdf"
+void Scene::addWrite(
+  const nlohmann::json& json,
+  size_t text,
+  const std::filesystem::path& fontPath,
+  graphics::Renderer& renderer
+)
+{
+  auto outlinePath = fontPath.string();
+  auto suffix = outlinePath.rfind("-msdf");
+  if (suffix != std::string::npos)
+  {
+    outlinePath.erase(suffix);
+  }
+  outlinePath = json.value("outline", outlinePath);
+
+  const auto& font = renderer.font(fontPath);
+  auto& outlines = renderer.outlines(
+    outlinePath,
+    font.size() * graphics::Text::scalingFactor
+  );
+
+  auto& write = _writes.emplace_back();
+  write.text = text;
+  write.startTime = json.value("start", 0.0f);
+  write.duration = std::max(json.value("duration", 1.0f), 1e-3f);
+  write.easing = json.contains("easing") ? readEasing(json)
+                                         : animation::Easing::Linear;
+  write.stroke = std::make_unique<graphics::TextStroke>(
+    renderer,
+    outlines,
+    *_texts[text],
+    json.value("thickness", 0.01f)
+  );
+}
+
+void Scene::evaluate(double time, graphics::FrameData& frame)
+{
+  TANIM_PROFILE_ZONE("Scene::evaluate");
+
+  _scheduler.update(time);
+  _timeline.evaluate(time);
+
+  frame.setCamera(_camera);
+
+  // before a morph only its source is visible, afterwards only its target
+  _visibleTexts.assign(_texts.size(), 1);
+  for (auto& morph : _morphs)
+  {
+    float t = ((float)time - morph.startTime) / morph.duration;
+    if (t < 0.0f)
+    {
+      _visibleTexts[morph.to] = 0;
+    }
+    else if (t >= 1.0f)
+    {
+      _visibleTexts[morph.from] = 0;
+    }
+    else
+    {
+      _visibleTexts[morph.from] = 0;
+      _visibleTexts[morph.to] = 0;
+      frame.addMorph(*morph.morph, animation::ease(morph.easing, t));
+    }
+  }
+
+  // a text is hidden until its outline is written completely
+  for (auto& write : _writes)
+  {
+    float t = ((float)time - write.startTime) / write.duration;
+    if (t >= 1.0f)
+    {
+      continue;
+    }
+
+    _visibleTexts[write.text] = 0;
+    if (t > 0.0f)
+    {
+      frame.addStroke(
+        *write.stroke,
+        *_texts[write.text],
+        animation::ease(write.easing, t)
+      );
+    }
+  }
+
+  for (size_t i = 0; i < _texts.size(); i++)
+  {
+    if (_visibleTexts[i])
+    {
+      frame.addText(*_texts[i]);
+    }
+  }
+
+  for (auto& number : _numbers)
+  {
+    frame.addText(*number);
+  }
+}
+
+bool Scene::changes(double from, double to)
+{
+  // scripts add the keys of a tween once they reach it, so the timeline is
+  // complete up to the later of both times afterwards
+  _scheduler.update(std::max(from, to));
+  if (_timeline.changes(from, to))
+  {
+    return true;
+  }
+
+  float begin = (float)std::min(from, to);
+  float end = (float)std::max(from, to);
+  auto overlaps = [&](float start, float duration)
+  { return start < end && start + duration > begin; };
+
+  for (const auto& morph : _morphs)
+  {
+    if (overlaps(morph.startTime, morph.duration))
+    {
+      return true;
+    }
+  }
+
+  for (const auto& write : _writes)
+  {
+    if (overlaps(write.startTime, write.duration))
+    {
+      return true;
+    }
+  }
+
+  for (const auto& text : _texts)
+  {
+    if (overlaps(text->effect().startTime, effectDuration(*text)))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+double Scene::nextChange(double time)
+{
+  _scheduler.update(time);
+
+  double next = std::min(_timeline.nextChange(time), _scheduler.nextWakeup());
+  auto consider = [&](float start, float duration)
+  {
+    if ((double)start + duration > time)
+    {
+      next = std::min(next, std::max((double)start, time));
+    }
+  };
+
+  for (const auto& morph : _morphs)
+  {
+    consider(morph.startTime, morph.duration);
+  }
+
+  for (const auto& write : _writes)
+  {
+    consider(write.startTime, write.duration);
+  }
+
+  for (const auto& text : _texts)
+  {
+    consider(text->effect().startTime, effectDuration(*text));
+  }
+
+  return next;
+}
+
+uint64_t Scene::revision() const
+{
+  uint64_t revision = _camera.revision();
+  for (const auto& text : _texts)
+  {
+    revision += text->revision();
+  }
+  for (const auto& number : _numbers)
+  {
+    revision += number->revision();
+  }
+  return revision;
+}
+}  // namespace scene
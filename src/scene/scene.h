@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+#include "animation/script.h"
+#include "animation/timeline.h"
+#include "graphics/camera.h"
+#include "graphics/number_text.h"
+#include "graphics/renderer.h"
+#include "graphics/text.h"
+#include "graphics/text_morph.h"
+#include "graphics/text_stroke.h"
+#include "video/frame_source.h"
+
+namespace scene
+{
+// Parsed scene file. The json is kept around so every worker thread can
+// build its own Scene from it.
+struct SceneDescription
+{
+  std::filesystem::path output;
+  uint32_t width = 1280;
+  uint32_t height = 720;
+  uint32_t frameRate = 60;
+  uint64_t frameCount = 0;
+
+  nlohmann::json json;
+
+  static SceneDescription load(const std::filesystem::path& path);
+  static SceneDescription parse(nlohmann::json json);
+
+  // every font the scene uses, so they can be loaded ahead of the scene
+  std::vector<std::filesystem::path> fonts() const;
+};
+
+class Scene;
+
+// Scripts are compiled into the executable and picked by name with the
+// "script" key of a scene file. Register them before any scene is created.
+using ScriptFactory = std::function<animation::Script(Scene&)>;
+
+void registerScript(const std::string& name, ScriptFactory factory);
+
+class Scene : public video::FrameSource
+{
+ public:
+  Scene(const SceneDescription& description, graphics::Renderer& renderer);
+  ~Scene() override = default;
+
+  void evaluate(double time, graphics::FrameData& frame) override;
+  bool changes(double from, double to) override;
+
+  // time of the next change at or after the time, infinity if the scene
+  // holds from there on
+  double nextChange(double time);
+
+  // changes whenever the camera, a text or a number was modified, so the
+  // preview only redraws when something is damaged
+  uint64_t revision() const;
+
+  graphics::Camera& camera()
+  {
+    return _camera;
+  }
+
+  animation::Timeline& timeline()
+  {
+    return _timeline;
+  }
+
+  animation::Scheduler& scheduler()
+  {
+    return _scheduler;
+  }
+
+  // texts are heap allocated, their characters keep pointers to the text
+  // transform and must not move
+  const std::vector<std::unique_ptr<graphics::Text>>& texts() const
+  {
+    return _texts;
+  }
+
+  const std::vector<std::unique_ptr<graphics::NumberText>>& numbers() const
+  {
+    return _numbers;
+  }
+
+ private:
+  struct Morph
+  {
+    size_t from;
+    size_t to;
+    float startTime;
+    float duration;
+    animation::Easing easing;
+    std::unique_ptr<graphics::TextMorph> morph;
+  };
+
+  struct Write
+  {
+    size_t text;
+    float startTime;
+    float duration;
+    animation::Easing easing;
+    std::unique_ptr<graphics::TextStroke> stroke;
+  };
+
+  void addAnimation(const nlohmann::json& json);
+  void addMorph(const nlohmann::json& json, graphics::Renderer& renderer);
+  void addWrite(
+    const nlohmann::json& json,
+    size_t text,
+    const std::filesystem::path& fontPath,
+    graphics::Renderer& renderer
+  );
+
+ private:
+  graphics::Camera _camera;
+  std::vector<std::unique_ptr<graphics::Text>> _texts;
+  std::vector<std::unique_ptr<graphics::NumberText>> _numbers;
+  std::vector<Morph> _morphs;
+  std::vector<Write> _writes;
+  std::vector<uint8_t> _visibleTexts;
+
+  animation::Timeline _timeline;
+  animation::Scheduler _scheduler{_timeline};
+};
+}  // namespace scene
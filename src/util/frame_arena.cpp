@@ -0,0 +1,102 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+
+namespace util
+{
+// blocks are aligned for any type, smaller alignments are bumped
+constexpr size_t blockAlignment = alignof(std::max_align_t);
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+FrameArena::FrameArena(
+  size_t blockSize,
+  uint32_t framesInFlight,
+  std::pmr::memory_resource* upstream
+)
+  : _blocks(std::max(framesInFlight, 1u)),
+    _upstream(upstream)
+{
+  for (auto& block : _blocks)
+  {
+    block.size = alignUp(std::max<size_t>(blockSize, 1), blockAlignment);
+    block.memory = static_cast<std::byte*>(
+      _upstream->allocate(block.size, blockAlignment)
+    );
+  }
+}
+
+FrameArena::~FrameArena()
+{
+  for (auto& block : _blocks)
+  {
+    release(block);
+    _upstream->deallocate(block.memory, block.size, blockAlignment);
+  }
+}
+
+void FrameArena::nextFrame()
+{
+  _current = (_current + 1) % _blocks.size();
+  auto& block = _blocks[_current];
+  release(block);
+
+  // grown once, the frames after fit without touching the upstream
+  if (block.demand > block.size)
+  {
+    size_t size =
+      alignUp(std::max(block.demand, block.size * 2), blockAlignment);
+    _upstream->deallocate(block.memory, block.size, blockAlignment);
+    block.memory =
+      static_cast<std::byte*>(_upstream->allocate(size, blockAlignment));
+    block.size = size;
+  }
+
+  block.offset = 0;
+  block.demand = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+  auto& block = _blocks[_current];
+  block.demand = alignUp(block.demand, alignment) + bytes;
+
+  size_t offset = alignUp(block.offset, alignment);
+  if (alignment <= blockAlignment && offset + bytes <= block.size)
+  {
+    block.offset = offset + bytes;
+    return block.memory + offset;
+  }
+
+  void* pointer = _upstream->allocate(bytes, alignment);
+  block.overflow.push_back({pointer, bytes, alignment});
+  return pointer;
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t)
+{
+  // released with the whole frame
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other
+) const noexcept
+{
+  return this == &other;
+}
+
+void FrameArena::release(Block& block)
+{
+  for (const auto& overflow : block.overflow)
+  {
+    _upstream->deallocate(
+      overflow.pointer,
+      overflow.bytes,
+      overflow.alignment
+    );
+  }
+  block.overflow.clear();
+}
+}  // namespace util
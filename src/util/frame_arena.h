@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace util
+{
+// Bump allocator for data which lives for a single frame, as a memory
+// resource for std::pmr containers. Every frame in flight has a block of
+// its own; nextFrame moves on to the oldest block and releases everything
+// allocated in it at once, so data of the previous frame stays valid for
+// another frame. Deallocating does nothing.
+//
+// A frame which outgrows its block is served by the upstream resource, and
+// the block is enlarged to the frame's demand the next time it is reused.
+// Once the frames have settled, allocating is a pointer bump. Not
+// thread-safe.
+class FrameArena : public std::pmr::memory_resource
+{
+ public:
+  static constexpr size_t defaultBlockSize = 1024 * 1024;
+
+  explicit FrameArena(
+    size_t blockSize = defaultBlockSize,
+    uint32_t framesInFlight = 2,
+    std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()
+  );
+  ~FrameArena() override;
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  void nextFrame();
+
+  // bytes bumped in the current block, without upstream allocations
+  size_t used() const
+  {
+    return _blocks[_current].offset;
+  }
+
+  size_t blockSize() const
+  {
+    return _blocks[_current].size;
+  }
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other
+  ) const noexcept override;
+
+ private:
+  struct Overflow
+  {
+    void* pointer;
+    size_t bytes;
+    size_t alignment;
+  };
+
+  struct Block
+  {
+    std::byte* memory = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+
+    // everything the frame asked for, including the overflow
+    size_t demand = 0;
+    std::vector<Overflow> overflow;
+  };
+
+  void release(Block& block);
+
+ private:
+  std::vector<Block> _blocks;
+  size_t _current = 0;
+
+  std::pmr::memory_resource* _upstream;
+};
+}  // namespace util
@@ -0,0 +1,51 @@
+#include "phase_timer.h"
+
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+namespace util
+{
+PhaseTimer::PhaseTimer(std::string tag)
+  : _tag(std::move(tag)),
+    _start(std::chrono::steady_clock::now()),
+    _last(_start)
+{
+}
+
+void PhaseTimer::mark(const char* name)
+{
+  auto now = std::chrono::steady_clock::now();
+  _phases.push_back(
+    {name, std::chrono::duration<double>(now - _last).count(), false}
+  );
+  _last = now;
+}
+
+void PhaseTimer::add(const char* name, double seconds)
+{
+  _phases.push_back({name, seconds, true});
+}
+
+double PhaseTimer::elapsed() const
+{
+  return std::chrono::duration<double>(
+           std::chrono::steady_clock::now() - _start
+  )
+    .count();
+}
+
+void PhaseTimer::report() const
+{
+  std::cerr << "[" << _tag << "] " << std::fixed << std::setprecision(1);
+  for (const auto& phase : _phases)
+  {
+    std::cerr << (phase.background ? "(" : "") << phase.name << " "
+              << phase.seconds * 1e3 << " ms" << (phase.background ? ")" : "")
+              << ", ";
+  }
+  std::cerr << "total "
+            << std::chrono::duration<double>(_last - _start).count() * 1e3
+            << " ms" << std::defaultfloat << std::endl;
+}
+}  // namespace util
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace util
+{
+// Wall clock durations of consecutive phases, e.g. of the startup. Every
+// mark ends the phase that began at the previous mark; work running on
+// another thread in the meantime is added with its own duration.
+class PhaseTimer
+{
+ public:
+  explicit PhaseTimer(std::string tag);
+  ~PhaseTimer() = default;
+
+  // name has to outlive the timer, e.g. a string literal
+  void mark(const char* name);
+
+  // a phase which overlapped the others, reported in parentheses
+  void add(const char* name, double seconds);
+
+  double elapsed() const;
+
+  // one line with every phase and the total, on stderr
+  void report() const;
+
+ private:
+  struct Phase
+  {
+    const char* name;
+    double seconds;
+    bool background;
+  };
+
+  std::string _tag;
+  std::vector<Phase> _phases;
+  std::chrono::steady_clock::time_point _start;
+  std::chrono::steady_clock::time_point _last;
+};
+}  // namespace util
@@ -0,0 +1,59 @@
+#include "pool_allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <new>
+
+namespace util
+{
+void* PoolAllocator::allocate(size_t size)
+{
+  if (size > maxBlockSize)
+  {
+    return ::operator new(size);
+  }
+
+  size_t index = sizeClass(size);
+  if (!_freeLists[index])
+  {
+    refill(index);
+  }
+
+  FreeBlock* block = _freeLists[index];
+  _freeLists[index] = block->next;
+  return block;
+}
+
+void PoolAllocator::deallocate(void* pointer, size_t size)
+{
+  if (size > maxBlockSize)
+  {
+    ::operator delete(pointer);
+    return;
+  }
+
+  size_t index = sizeClass(size);
+  auto* block = static_cast<FreeBlock*>(pointer);
+  block->next = _freeLists[index];
+  _freeLists[index] = block;
+}
+
+size_t PoolAllocator::sizeClass(size_t size)
+{
+  size_t blockSize = std::bit_ceil(std::max(size, minBlockSize));
+  return std::countr_zero(blockSize) - std::countr_zero(minBlockSize);
+}
+
+void PoolAllocator::refill(size_t sizeClass)
+{
+  size_t blockSize = minBlockSize << sizeClass;
+
+  auto& chunk = _chunks.emplace_back(new std::byte[chunkSize]);
+  for (size_t offset = 0; offset + blockSize <= chunkSize; offset += blockSize)
+  {
+    auto* block = reinterpret_cast<FreeBlock*>(chunk.get() + offset);
+    block->next = _freeLists[sizeClass];
+    _freeLists[sizeClass] = block;
+  }
+}
+}  // namespace util
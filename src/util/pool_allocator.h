@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace util
+{
+// Free list allocator for small, short lived objects of varying size, like
+// coroutine frames. Blocks are grouped into power of two size classes and
+// carved out of large chunks, freed blocks are reused without touching the
+// global heap. Larger requests fall back to operator new. Not thread-safe.
+class PoolAllocator
+{
+ public:
+  static constexpr size_t minBlockSize = 64;
+  static constexpr size_t maxBlockSize = 4096;
+  static constexpr size_t chunkSize = 64 * 1024;
+
+  PoolAllocator() = default;
+  ~PoolAllocator() = default;
+
+  PoolAllocator(const PoolAllocator&) = delete;
+  PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+  void* allocate(size_t size);
+  void deallocate(void* pointer, size_t size);
+
+  size_t reservedBytes() const
+  {
+    return _chunks.size() * chunkSize;
+  }
+
+ private:
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  static constexpr size_t sizeClassCount = 7;
+
+  static size_t sizeClass(size_t size);
+
+  void refill(size_t sizeClass);
+
+ private:
+  std::array<FreeBlock*, sizeClassCount> _freeLists{};
+  std::vector<std::unique_ptr<std::byte[]>> _chunks;
+};
+}  // namespace util
@@ -0,0 +1,234 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace util
+{
+struct ProfileEvent
+{
+  const char* name;
+  uint64_t start;
+  uint64_t end;
+};
+
+// written by its thread only, the count is published with release semantics
+// so a reader sees complete events
+struct ThreadEvents
+{
+  uint32_t id;
+  std::string name;
+  std::unique_ptr<ProfileEvent[]> events;
+  std::atomic<uint64_t> count = 0;
+};
+
+static std::mutex threadsMutex;
+static std::vector<std::unique_ptr<ThreadEvents>> threads;
+
+// buffers of exited threads, continued by the next thread which registers
+static std::vector<ThreadEvents*> freeThreads;
+
+// timestamps at the start of the capture, to convert ticks to nanoseconds
+static uint64_t captureTicks = 0;
+static uint64_t captureNanoseconds = 0;
+
+static uint64_t captureFirstFrame = 0;
+static uint64_t captureEndFrame = 0;
+static std::atomic<uint64_t> currentFrame = 0;
+static bool captureRequested = false;
+
+static thread_local const char* threadName = nullptr;
+static thread_local ThreadEvents* threadEvents = nullptr;
+static ThreadEvents* gpuEvents = nullptr;
+
+// hands the buffer of the thread on once it exits
+struct ThreadRegistration
+{
+  ThreadEvents* events = nullptr;
+
+  ~ThreadRegistration()
+  {
+    if (events)
+    {
+      std::lock_guard lock(threadsMutex);
+      freeThreads.push_back(events);
+    }
+  }
+};
+static thread_local ThreadRegistration threadRegistration;
+
+static ThreadEvents& registerEvents(const char* name)
+{
+  std::lock_guard lock(threadsMutex);
+  auto& events = threads.emplace_back(std::make_unique<ThreadEvents>());
+  events->id = (uint32_t)threads.size();
+  events->name = name ? name : "Thread " + std::to_string(events->id);
+  events->events = std::make_unique<ProfileEvent[]>(Profiler::eventsPerThread);
+  return *events;
+}
+
+static ThreadEvents& registerThread()
+{
+  // buffers stay registered after their thread exited, so zones of joined
+  // worker threads are still written. The next thread continues the ring
+  // of such a buffer, so the number of buffers is bounded by the number of
+  // threads alive at once instead of growing with every worker started.
+  {
+    std::lock_guard lock(threadsMutex);
+    if (!freeThreads.empty())
+    {
+      threadEvents = freeThreads.back();
+      freeThreads.pop_back();
+      if (threadName)
+      {
+        threadEvents->name = threadName;
+      }
+    }
+  }
+
+  if (!threadEvents)
+  {
+    threadEvents = &registerEvents(threadName);
+  }
+
+  threadRegistration.events = threadEvents;
+  return *threadEvents;
+}
+
+static void push(ThreadEvents& events, const ProfileEvent& event)
+{
+  // the ring keeps the latest events if a thread records more than fit
+  uint64_t count = events.count.load(std::memory_order_relaxed);
+  events.events[count % Profiler::eventsPerThread] = event;
+  events.count.store(count + 1, std::memory_order_release);
+}
+
+void Profiler::capture(uint64_t firstFrame, uint64_t frameCount)
+{
+  captureFirstFrame = firstFrame;
+  captureEndFrame = firstFrame + frameCount;
+  captureRequested = true;
+
+  captureTicks = now();
+  captureNanoseconds = steadyNow();
+}
+
+void Profiler::beginFrame(uint64_t frame)
+{
+  currentFrame.store(frame, std::memory_order_relaxed);
+  _capturing.store(
+    captureRequested && frame >= captureFirstFrame && frame < captureEndFrame,
+    std::memory_order_relaxed
+  );
+}
+
+bool Profiler::finished()
+{
+  return captureRequested &&
+         currentFrame.load(std::memory_order_relaxed) >= captureEndFrame;
+}
+
+void Profiler::setThreadName(const char* name)
+{
+  threadName = name;
+  if (threadEvents)
+  {
+    std::lock_guard lock(threadsMutex);
+    threadEvents->name = name;
+  }
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end)
+{
+  push(threadEvents ? *threadEvents : registerThread(), {name, start, end});
+}
+
+void Profiler::recordGpu(const char* name, uint64_t start, uint64_t end)
+{
+  if (!gpuEvents)
+  {
+    gpuEvents = &registerEvents("GPU");
+  }
+  push(*gpuEvents, {name, start, end});
+}
+
+uint64_t Profiler::ticks(uint64_t nanoseconds)
+{
+  uint64_t elapsedNanoseconds = steadyNow() - captureNanoseconds;
+  if (elapsedNanoseconds == 0)
+  {
+    return nanoseconds;
+  }
+
+  double ticksPerNanosecond =
+    (double)(now() - captureTicks) / (double)elapsedNanoseconds;
+  return (uint64_t)((double)nanoseconds * ticksPerNanosecond);
+}
+
+bool Profiler::writeTrace(const std::filesystem::path& path)
+{
+  std::ofstream file(path);
+  if (!file.is_open())
+  {
+    std::cerr << "[Profiler] Could not open " << path.string() << std::endl;
+    return false;
+  }
+
+  std::lock_guard lock(threadsMutex);
+
+  uint64_t ticks = now() - captureTicks;
+  uint64_t nanoseconds = steadyNow() - captureNanoseconds;
+  double microsecondsPerTick =
+    ticks > 0 ? (double)nanoseconds / (double)ticks / 1e3 : 1e-3;
+
+  uint64_t origin = UINT64_MAX;
+  for (const auto& thread : threads)
+  {
+    uint64_t count = thread->count.load(std::memory_order_acquire);
+    uint64_t first = count > eventsPerThread ? count - eventsPerThread : 0;
+    for (uint64_t i = first; i < count; i++)
+    {
+      origin = std::min(origin, thread->events[i % eventsPerThread].start);
+    }
+  }
+
+  // chrome traces use microseconds, relative to the first recorded zone
+  file << "{\"traceEvents\":[\n";
+  file << std::fixed << std::setprecision(3);
+
+  bool first = true;
+  size_t eventCount = 0;
+  for (const auto& thread : threads)
+  {
+    file << (first ? "" : ",\n")
+         << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+         << thread->id << ",\"args\":{\"name\":\"" << thread->name << "\"}}";
+    first = false;
+
+    uint64_t count = thread->count.load(std::memory_order_acquire);
+    uint64_t begin = count > eventsPerThread ? count - eventsPerThread : 0;
+    for (uint64_t i = begin; i < count; i++)
+    {
+      const auto& event = thread->events[i % eventsPerThread];
+      double start = (double)(event.start - origin) * microsecondsPerTick;
+      double duration = (double)(event.end - event.start) * microsecondsPerTick;
+      file << ",\n{\"name\":\"" << event.name
+           << "\",\"cat\":\"tanim\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+           << thread->id << ",\"ts\":" << start << ",\"dur\":" << duration
+           << "}";
+      eventCount++;
+    }
+  }
+  file << "\n]}\n";
+
+  std::cerr << "[Profiler] Wrote " << eventCount << " zones to "
+            << path.string() << std::endl;
+  return file.good();
+}
+}  // namespace util
@@ -1,5 +1,6 @@
 #include "transform.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace util
@@ -26,8 +27,10 @@ void Transform::setParent(Transform* parent)
   {
     auto& siblings = _parent->_children;
 
-    auto it = std::find(siblings.begin(), siblings.end(), this);
-    size_t index = std::distance(siblings.begin(), it);
+    // children are usually detached in reverse order, e.g. the glyphs of a
+    // text being laid out again
+    auto it = std::find(siblings.rbegin(), siblings.rend(), this);
+    size_t index = std::distance(it, siblings.rend()) - 1;
     swapRemove(siblings, index);
   }
 
@@ -88,6 +91,7 @@ void Transform::setOrigin(const glm::vec3& origin)
 void Transform::markDirty()
 {
   _dirty = true;
+  _revision++;
 
   for (auto child : _children)
   {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -47,6 +48,13 @@ class Transform
   }
   void setOrigin(const glm::vec3& origin);
 
+  // incremented whenever the matrix changes, compare against a previous
+  // value to find out whether anything has to be redrawn
+  uint64_t revision() const
+  {
+    return _revision;
+  }
+
  private:
   void markDirty();
 
@@ -65,5 +73,6 @@ class Transform
   glm::vec3 _origin{0.0f};
 
   bool _dirty = true;
+  uint64_t _revision = 0;
 };
 }  // namespace util
@@ -0,0 +1,146 @@
+#include "exporter.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "util/profiler.h"
+#include "video/frame_pipeline.h"
+
+namespace video
+{
+// thrown by the submit callback, stops the frame pipeline
+struct ReadbackError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+Exporter::Exporter(
+  const wgpu::Instance& instance,
+  const wgpu::Device& device,
+  const wgpu::Queue& queue,
+  graphics::Renderer& renderer,
+  uint32_t threadCount
+)
+  : _threadCount(threadCount),
+    _renderer(renderer),
+    _instance(instance),
+    _device(device),
+    _queue(queue)
+{
+}
+
+bool Exporter::render(
+  const FrameSourceFactory& factory,
+  const animation::Clock& clock,
+  uint64_t firstFrame,
+  uint64_t frameCount,
+  uint32_t width,
+  uint32_t height,
+  const std::filesystem::path& path
+)
+{
+  std::ofstream output(path, std::ios::binary);
+  if (!output.is_open())
+  {
+    std::cerr << "[Export] Could not open " << path.string() << std::endl;
+    return false;
+  }
+
+  if (!_converter || _converter->width() != width ||
+      _converter->height() != height)
+  {
+    resize(width, height);
+  }
+
+  uint64_t heldFrameCount = 0;
+
+  // scene evaluation runs on worker threads, this thread only submits
+  auto pipeline = FramePipeline(factory, clock, _threadCount);
+  try
+  {
+    pipeline.run(
+      firstFrame,
+      frameCount,
+      [&](const graphics::FrameData& frame)
+      {
+        util::Profiler::beginFrame(frame.frame);
+        TANIM_PROFILE_ZONE("Exporter::submit");
+        auto start = std::chrono::steady_clock::now();
+
+        // holds write the planes of the previous frame again, without touching
+        // the GPU
+        if (frame.hold)
+        {
+          heldFrameCount++;
+        }
+        else
+        {
+          _renderer.drawFrame(frame);
+          _renderer.flush(_targetView);
+
+          _converter->convert(_targetView);
+          if (!_converter->read(_instance, _planes))
+          {
+            // the planes still hold the previous frame
+            throw ReadbackError(
+              "Could not read back frame " + std::to_string(frame.frame)
+            );
+          }
+        }
+        output.write(
+          (const char*)_planes.data(),
+          (std::streamsize)_planes.size()
+        );
+
+        _renderer.stats().endFrame(
+          frame.frame,
+          std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+          )
+            .count()
+        );
+      }
+    );
+  }
+  catch (const ReadbackError& error)
+  {
+    std::cerr << "[Export] " << error.what() << std::endl;
+    return false;
+  }
+
+  if (heldFrameCount > 0)
+  {
+    std::cerr << "[Export] Repeated " << heldFrameCount << " of "
+              << frameCount << " frames" << std::endl;
+  }
+
+  return output.good();
+}
+
+void Exporter::resize(uint32_t width, uint32_t height)
+{
+  _converter.reset();
+  _converter.emplace(
+    _device,
+    _queue,
+    _renderer.gpuTimer(),
+    width,
+    height
+  );
+
+  wgpu::TextureDescriptor targetDescriptor{};
+  targetDescriptor.label = "Export Render Target";
+  targetDescriptor.dimension = wgpu::TextureDimension::e2D;
+  targetDescriptor.size = {width, height, 1};
+  targetDescriptor.mipLevelCount = 1;
+  targetDescriptor.sampleCount = 1;
+  targetDescriptor.format = format;
+  targetDescriptor.usage =
+    wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding;
+  _target = _device.CreateTexture(&targetDescriptor);
+  _targetView = _target.CreateView();
+}
+}  // namespace video
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "animation/clock.h"
+#include "graphics/renderer.h"
+#include "graphics/yuv_converter.h"
+#include "video/frame_source.h"
+
+namespace video
+{
+// Renders frame ranges offscreen and writes them as raw YUV420, which can be
+// encoded with e.g. `ffmpeg -f rawvideo -pix_fmt yuv420p -s 1280x720`.
+// The render target and converter are kept between calls, so consecutive
+// exports of the same resolution reuse all GPU resources.
+class Exporter
+{
+ public:
+  static constexpr wgpu::TextureFormat format =
+    wgpu::TextureFormat::RGBA8Unorm;
+
+  // the renderer has to be created with Exporter::format
+  Exporter(
+    const wgpu::Instance& instance,
+    const wgpu::Device& device,
+    const wgpu::Queue& queue,
+    graphics::Renderer& renderer,
+    uint32_t threadCount
+  );
+  ~Exporter() = default;
+
+  bool render(
+    const FrameSourceFactory& factory,
+    const animation::Clock& clock,
+    uint64_t firstFrame,
+    uint64_t frameCount,
+    uint32_t width,
+    uint32_t height,
+    const std::filesystem::path& path
+  );
+
+ private:
+  void resize(uint32_t width, uint32_t height);
+
+ private:
+  uint32_t _threadCount;
+
+  wgpu::Texture _target;
+  wgpu::TextureView _targetView;
+  std::optional<graphics::YuvConverter> _converter;
+  std::vector<uint8_t> _planes;
+
+  graphics::Renderer& _renderer;
+
+  const wgpu::Instance& _instance;
+  const wgpu::Device& _device;
+  const wgpu::Queue& _queue;
+};
+}  // namespace video
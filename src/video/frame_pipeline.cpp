@@ -0,0 +1,169 @@
+#include "frame_pipeline.h"
+
+#include <stdexcept>
+
+#include "util/profiler.h"
+
+namespace video
+{
+// slots per worker, enough to keep every worker busy while the submission
+// thread waits on the GPU for a frame
+constexpr uint32_t slotsPerWorker = 2;
+
+FramePipeline::FramePipeline(
+  const FrameSourceFactory& factory,
+  const animation::Clock& clock,
+  uint32_t workerCount
+)
+  : _clock(clock)
+{
+  if (workerCount == 0)
+  {
+    throw std::invalid_argument("FramePipeline requires at least one worker");
+  }
+
+  // sources are created here on the calling thread, so factories may use
+  // resources which are not thread-safe to create (fonts, renderer caches)
+  _sources.reserve(workerCount);
+  for (uint32_t i = 0; i < workerCount; i++)
+  {
+    _sources.emplace_back(factory());
+  }
+
+  _slots.resize(workerCount * slotsPerWorker);
+}
+
+void FramePipeline::run(
+  uint64_t firstFrame,
+  uint64_t frameCount,
+  const std::function<void(const graphics::FrameData&)>& submit
+)
+{
+  const uint64_t endFrame = firstFrame + frameCount;
+
+  _firstFrame = firstFrame;
+  _nextFrame = firstFrame;
+  _submittedFrame = firstFrame;
+  _endFrame = endFrame;
+  _error = nullptr;
+  for (auto& slot : _slots)
+  {
+    slot.ready = false;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(_sources.size());
+  for (auto& source : _sources)
+  {
+    workers.emplace_back(&FramePipeline::work, this, std::ref(*source));
+  }
+
+  for (uint64_t frame = firstFrame; frame < endFrame; frame++)
+  {
+    auto& slot = _slots[frame % _slots.size()];
+    {
+      std::unique_lock lock(_mutex);
+      _evaluated.wait(lock, [&] { return slot.ready || _error; });
+      if (_error)
+      {
+        break;
+      }
+    }
+
+    // the workers are stopped and joined below before the error propagates
+    try
+    {
+      submit(slot.data);
+    }
+    catch (...)
+    {
+      std::lock_guard lock(_mutex);
+      if (!_error)
+      {
+        _error = std::current_exception();
+      }
+      break;
+    }
+
+    {
+      std::lock_guard lock(_mutex);
+      slot.ready = false;
+      _submittedFrame = frame + 1;
+    }
+    _submitted.notify_all();
+  }
+
+  {
+    std::lock_guard lock(_mutex);
+    _endFrame = _nextFrame;
+  }
+  _submitted.notify_all();
+
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  if (_error)
+  {
+    std::rethrow_exception(_error);
+  }
+}
+
+void FramePipeline::work(FrameSource& source)
+{
+  TANIM_PROFILE_THREAD("Frame Worker");
+
+  while (true)
+  {
+    uint64_t frame;
+    {
+      std::unique_lock lock(_mutex);
+      _submitted.wait(
+        lock,
+        [&]
+        {
+          return _nextFrame >= _endFrame ||
+                 _nextFrame < _submittedFrame + _slots.size();
+        }
+      );
+      if (_nextFrame >= _endFrame || _error)
+      {
+        return;
+      }
+      frame = _nextFrame++;
+    }
+
+    // the slot of this frame was released when frame - slots.size() got
+    // submitted, so it is owned exclusively by this worker until ready
+    auto& slot = _slots[frame % _slots.size()];
+    try
+    {
+      TANIM_PROFILE_ZONE("FramePipeline::evaluate");
+      slot.data.reset(frame, _clock.frameTime(frame));
+      slot.data.hold =
+        frame > _firstFrame &&
+        !source.changes(_clock.frameTime(frame - 1), slot.data.time);
+      if (!slot.data.hold)
+      {
+        source.evaluate(slot.data.time, slot.data);
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard lock(_mutex);
+      _error = std::current_exception();
+      _endFrame = _nextFrame;
+      _evaluated.notify_all();
+      _submitted.notify_all();
+      return;
+    }
+
+    {
+      std::lock_guard lock(_mutex);
+      slot.ready = true;
+    }
+    _evaluated.notify_all();
+  }
+}
+}  // namespace video
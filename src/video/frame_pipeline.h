@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "animation/clock.h"
+#include "graphics/frame_data.h"
+#include "video/frame_source.h"
+
+namespace video
+{
+// Evaluates frames of an offline render on several worker threads and hands
+// them to the calling thread strictly in order. Every worker owns its own
+// frame source, together the workers run at most two frames per worker
+// ahead of submission. Frames which look like their predecessor are marked
+// as holds instead of being evaluated.
+class FramePipeline
+{
+ public:
+  FramePipeline(
+    const FrameSourceFactory& factory,
+    const animation::Clock& clock,
+    uint32_t workerCount
+  );
+  ~FramePipeline() = default;
+
+  void run(
+    uint64_t firstFrame,
+    uint64_t frameCount,
+    const std::function<void(const graphics::FrameData&)>& submit
+  );
+
+  uint32_t workerCount() const
+  {
+    return (uint32_t)_sources.size();
+  }
+
+ private:
+  struct Slot
+  {
+    graphics::FrameData data;
+    bool ready = false;
+  };
+
+  void work(FrameSource& source);
+
+ private:
+  const animation::Clock& _clock;
+
+  std::vector<std::unique_ptr<FrameSource>> _sources;
+  std::vector<Slot> _slots;
+
+  std::mutex _mutex;
+  std::condition_variable _evaluated;
+  std::condition_variable _submitted;
+
+  uint64_t _firstFrame = 0;
+  uint64_t _nextFrame = 0;
+  uint64_t _submittedFrame = 0;
+  uint64_t _endFrame = 0;
+  std::exception_ptr _error;
+};
+}  // namespace video
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "graphics/frame_data.h"
+
+namespace video
+{
+// A scene that can be evaluated at an arbitrary time. Implementations must
+// produce the same frame data for the same time, independent of the order in
+// which frames are evaluated.
+class FrameSource
+{
+ public:
+  virtual ~FrameSource() = default;
+
+  virtual void evaluate(double time, graphics::FrameData& frame) = 0;
+
+  // false if the frame at `to` is guaranteed to look exactly like the frame
+  // at `from`, which lets renders repeat the previous frame
+  virtual bool changes(double from, double to)
+  {
+    return true;
+  }
+};
+
+using FrameSourceFactory = std::function<std::unique_ptr<FrameSource>()>;
+}  // namespace video
@@ -0,0 +1,570 @@
+#include "render_farm.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace video
+{
+#ifndef _WIN32
+constexpr int pollInterval = 500;
+
+static bool
+createAddress(const std::filesystem::path& path, sockaddr_un& address)
+{
+  auto string = path.string();
+  if (string.size() >= sizeof(address.sun_path))
+  {
+    std::cerr << "[Farm] Socket path is too long: " << string << std::endl;
+    return false;
+  }
+
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, string.c_str(), string.size() + 1);
+  return true;
+}
+
+static bool sendMessage(int socket, const std::string& message)
+{
+  size_t sent = 0;
+  while (sent < message.size())
+  {
+    auto result =
+      ::send(socket, message.data() + sent, message.size() - sent, 0);
+    if (result <= 0)
+    {
+      return false;
+    }
+    sent += (size_t)result;
+  }
+  return true;
+}
+
+FarmCoordinator::FarmCoordinator(const FarmOptions& options) : _options(options)
+{
+  for (uint64_t first = 0; first < options.frameCount;
+       first += options.chunkFrameCount)
+  {
+    auto& chunk = _chunks.emplace_back();
+    chunk.firstFrame = first;
+    chunk.frameCount =
+      std::min(options.chunkFrameCount, options.frameCount - first);
+  }
+}
+
+FarmCoordinator::~FarmCoordinator()
+{
+  for (auto& connection : _connections)
+  {
+    ::close(connection.socket);
+  }
+
+  if (_socket >= 0)
+  {
+    ::close(_socket);
+    ::unlink(_options.socketPath.string().c_str());
+  }
+
+  for (int worker : _workers)
+  {
+    ::kill(worker, SIGTERM);
+    ::waitpid(worker, nullptr, 0);
+  }
+
+  // duplicates still rendering when the render finished or failed
+  for (auto& connection : _connections)
+  {
+    if (connection.assigned)
+    {
+      std::error_code error;
+      std::filesystem::remove(connection.output, error);
+    }
+  }
+}
+
+int FarmCoordinator::run()
+{
+  // a worker dying mid-send must not take the coordinator down with it
+  ::signal(SIGPIPE, SIG_IGN);
+
+  if (_options.chunkFrameCount == 0 || !listen() || !spawnWorkers())
+  {
+    return 1;
+  }
+
+  std::vector<pollfd> descriptors;
+  while (!finished() && !_failed)
+  {
+    reapWorkers();
+    if (_connections.empty() && _workers.empty() && _options.workerCount > 0)
+    {
+      std::cerr << "[Farm] All workers exited before the render finished"
+                << std::endl;
+      return 1;
+    }
+
+    descriptors.clear();
+    descriptors.push_back({_socket, POLLIN, 0});
+    for (auto& connection : _connections)
+    {
+      descriptors.push_back({connection.socket, POLLIN, 0});
+    }
+
+    if (::poll(descriptors.data(), descriptors.size(), pollInterval) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      std::cerr << "[Farm] poll failed: " << std::strerror(errno) << std::endl;
+      return 1;
+    }
+
+    // iterate backwards, dead connections are removed in place
+    for (size_t i = descriptors.size() - 1; i > 0; i--)
+    {
+      if (descriptors[i].revents == 0)
+      {
+        continue;
+      }
+
+      auto& connection = _connections[i - 1];
+      if (!receive(connection))
+      {
+        release(connection);
+        ::close(connection.socket);
+        _connections.erase(_connections.begin() + (i - 1));
+      }
+    }
+
+    if (descriptors[0].revents & POLLIN)
+    {
+      accept();
+    }
+
+    expireChunks();
+    for (auto& connection : _connections)
+    {
+      if (connection.ready && !connection.assigned)
+      {
+        assign(connection);
+      }
+    }
+  }
+
+  if (_failed)
+  {
+    return 1;
+  }
+
+  for (auto& connection : _connections)
+  {
+    sendMessage(connection.socket, "EXIT\n");
+  }
+
+  return stitch() ? 0 : 1;
+}
+
+bool FarmCoordinator::listen()
+{
+  sockaddr_un address;
+  if (!createAddress(_options.socketPath, address))
+  {
+    return false;
+  }
+
+  ::unlink(address.sun_path);
+
+  _socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (_socket < 0 ||
+      ::bind(_socket, (const sockaddr*)&address, sizeof(address)) != 0 ||
+      ::listen(_socket, SOMAXCONN) != 0)
+  {
+    std::cerr << "[Farm] Could not listen on " << _options.socketPath.string()
+              << ": " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool FarmCoordinator::spawnWorkers()
+{
+  std::vector<std::string> arguments = _options.workerCommand;
+  arguments.push_back("--farm-worker");
+  arguments.push_back(_options.socketPath.string());
+
+  std::vector<char*> argv;
+  for (auto& argument : arguments)
+  {
+    argv.push_back(argument.data());
+  }
+  argv.push_back(nullptr);
+
+  for (uint32_t i = 0; i < _options.workerCount; i++)
+  {
+    int pid = ::fork();
+    if (pid < 0)
+    {
+      std::cerr << "[Farm] Could not spawn worker: " << std::strerror(errno)
+                << std::endl;
+      return false;
+    }
+
+    if (pid == 0)
+    {
+      ::execvp(argv[0], argv.data());
+      std::cerr << "[Farm] Could not execute " << argv[0] << ": "
+                << std::strerror(errno) << std::endl;
+      ::_exit(127);
+    }
+
+    _workers.push_back(pid);
+  }
+
+  return true;
+}
+
+void FarmCoordinator::reapWorkers()
+{
+  for (size_t i = 0; i < _workers.size();)
+  {
+    if (::waitpid(_workers[i], nullptr, WNOHANG) == _workers[i])
+    {
+      _workers.erase(_workers.begin() + i);
+      continue;
+    }
+    i++;
+  }
+}
+
+void FarmCoordinator::accept()
+{
+  int socket = ::accept(_socket, nullptr, nullptr);
+  if (socket < 0)
+  {
+    return;
+  }
+
+  auto& connection = _connections.emplace_back();
+  connection.socket = socket;
+}
+
+bool FarmCoordinator::receive(Connection& connection)
+{
+  char data[256];
+  auto count = ::recv(connection.socket, data, sizeof(data), 0);
+  if (count <= 0)
+  {
+    return false;
+  }
+
+  connection.buffer.append(data, (size_t)count);
+
+  size_t end;
+  while ((end = connection.buffer.find('\n')) != std::string::npos)
+  {
+    auto message = connection.buffer.substr(0, end);
+    connection.buffer.erase(0, end + 1);
+    if (!handle(connection, message))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool FarmCoordinator::handle(Connection& connection, std::string_view message)
+{
+  std::istringstream stream{std::string(message)};
+  std::string command;
+  stream >> command;
+
+  if (command == "READY")
+  {
+    connection.ready = true;
+    assign(connection);
+    return true;
+  }
+
+  size_t index;
+  if (!(stream >> index) || !connection.assigned || connection.chunk != index)
+  {
+    std::cerr << "[Farm] Unexpected message from worker: " << message
+              << std::endl;
+    return false;
+  }
+
+  auto& chunk = _chunks[index];
+  if (command == "DONE")
+  {
+    connection.assigned = false;
+    chunk.renderers--;
+
+    if (chunk.state == ChunkState::Done)
+    {
+      // lost the race against a duplicate of this chunk
+      std::filesystem::remove(connection.output);
+    }
+    else
+    {
+      chunk.state = ChunkState::Done;
+      chunk.output = connection.output;
+    }
+
+    assign(connection);
+    return true;
+  }
+
+  if (command == "FAILED")
+  {
+    release(connection);
+    assign(connection);
+    return true;
+  }
+
+  std::cerr << "[Farm] Unknown message from worker: " << message << std::endl;
+  return false;
+}
+
+void FarmCoordinator::assign(Connection& connection)
+{
+  // prefer chunks nobody is working on, then duplicate expired chunks
+  Chunk* next = nullptr;
+  for (auto& chunk : _chunks)
+  {
+    if (chunk.state == ChunkState::Pending)
+    {
+      next = &chunk;
+      break;
+    }
+
+    if (!next && chunk.state == ChunkState::Rendering && chunk.expired &&
+        chunk.renderers == 1)
+    {
+      next = &chunk;
+    }
+  }
+
+  if (!next)
+  {
+    return;
+  }
+
+  size_t index = next - _chunks.data();
+  next->state = ChunkState::Rendering;
+  next->renderers++;
+  next->attempts++;
+
+  connection.assigned = true;
+  connection.chunk = index;
+  connection.output = _options.outputPath;
+  connection.output += ".part" + std::to_string(index) + "-" +
+                       std::to_string(next->attempts);
+  connection.deadline =
+    std::chrono::steady_clock::now() + _options.chunkTimeout;
+
+  std::ostringstream message;
+  message << "CHUNK " << index << " " << next->firstFrame << " "
+          << next->frameCount << " " << connection.output.string() << "\n";
+  if (!sendMessage(connection.socket, message.str()))
+  {
+    release(connection);
+  }
+}
+
+void FarmCoordinator::release(Connection& connection)
+{
+  if (!connection.assigned)
+  {
+    return;
+  }
+
+  connection.assigned = false;
+
+  // whatever the worker wrote of the chunk is incomplete
+  std::error_code error;
+  std::filesystem::remove(connection.output, error);
+
+  // only called when a render failed or its worker went away
+  auto& chunk = _chunks[connection.chunk];
+  chunk.renderers--;
+  chunk.failures++;
+  if (chunk.state != ChunkState::Rendering || chunk.renderers > 0)
+  {
+    return;
+  }
+
+  if (chunk.failures >= _options.maxFailures)
+  {
+    std::cerr << "[Farm] Chunk starting at frame " << chunk.firstFrame
+              << " failed " << chunk.failures << " times" << std::endl;
+    _failed = true;
+    return;
+  }
+
+  chunk.state = ChunkState::Pending;
+  chunk.expired = false;
+}
+
+void FarmCoordinator::expireChunks()
+{
+  auto now = std::chrono::steady_clock::now();
+  for (auto& connection : _connections)
+  {
+    if (connection.assigned && now > connection.deadline)
+    {
+      _chunks[connection.chunk].expired = true;
+    }
+  }
+}
+
+bool FarmCoordinator::finished() const
+{
+  for (auto& chunk : _chunks)
+  {
+    if (chunk.state != ChunkState::Done)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FarmCoordinator::stitch()
+{
+  std::ofstream output(_options.outputPath, std::ios::binary);
+  if (!output.is_open())
+  {
+    std::cerr << "[Farm] Could not open " << _options.outputPath.string()
+              << std::endl;
+    return false;
+  }
+
+  for (auto& chunk : _chunks)
+  {
+    {
+      std::ifstream part(chunk.output, std::ios::binary);
+      if (!part.is_open())
+      {
+        std::cerr << "[Farm] Missing chunk " << chunk.output.string()
+                  << std::endl;
+        return false;
+      }
+      output << part.rdbuf();
+    }
+    std::filesystem::remove(chunk.output);
+  }
+
+  return true;
+}
+
+int runFarmWorker(
+  const std::filesystem::path& socketPath,
+  const ChunkRenderer& render
+)
+{
+  sockaddr_un address;
+  if (!createAddress(socketPath, address))
+  {
+    return 1;
+  }
+
+  int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket < 0 ||
+      ::connect(socket, (const sockaddr*)&address, sizeof(address)) != 0)
+  {
+    std::cerr << "[Farm] Could not connect to " << socketPath.string() << ": "
+              << std::strerror(errno) << std::endl;
+    return 1;
+  }
+
+  sendMessage(socket, "READY\n");
+
+  std::string buffer;
+  char data[256];
+  while (true)
+  {
+    size_t end = buffer.find('\n');
+    if (end == std::string::npos)
+    {
+      auto count = ::recv(socket, data, sizeof(data), 0);
+      if (count <= 0)
+      {
+        break;
+      }
+      buffer.append(data, (size_t)count);
+      continue;
+    }
+
+    std::istringstream stream(buffer.substr(0, end));
+    buffer.erase(0, end + 1);
+
+    std::string command;
+    stream >> command;
+    if (command == "EXIT")
+    {
+      break;
+    }
+
+    size_t index;
+    uint64_t firstFrame, frameCount;
+    std::string output;
+    if (command != "CHUNK" || !(stream >> index >> firstFrame >> frameCount))
+    {
+      std::cerr << "[Farm] Unexpected message from coordinator" << std::endl;
+      break;
+    }
+    std::getline(stream >> std::ws, output);
+
+    bool rendered = render(firstFrame, frameCount, output);
+    std::string reply = rendered ? "DONE " : "FAILED ";
+    if (!sendMessage(socket, reply + std::to_string(index) + "\n"))
+    {
+      break;
+    }
+  }
+
+  ::close(socket);
+  return 0;
+}
+#else
+FarmCoordinator::FarmCoordinator(const FarmOptions& options) : _options(options)
+{
+}
+
+FarmCoordinator::~FarmCoordinator() = default;
+
+int FarmCoordinator::run()
+{
+  std::cerr << "[Farm] Render farm mode is not supported on Windows"
+            << std::endl;
+  return 1;
+}
+
+int runFarmWorker(
+  const std::filesystem::path& socketPath,
+  const ChunkRenderer& render
+)
+{
+  std::cerr << "[Farm] Render farm mode is not supported on Windows"
+            << std::endl;
+  return 1;
+}
+#endif
+}  // namespace video
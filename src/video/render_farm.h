@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace video
+{
+struct FarmOptions
+{
+  std::filesystem::path socketPath;
+  std::filesystem::path outputPath;
+  uint64_t frameCount = 0;
+  uint64_t chunkFrameCount = 60;
+
+  // number of child processes to spawn, external workers may connect to the
+  // socket in addition to (or instead of) them
+  uint32_t workerCount = 0;
+  std::vector<std::string> workerCommand;
+
+  // chunks taking longer than this are handed to a second worker as well,
+  // whichever finishes first wins
+  std::chrono::seconds chunkTimeout{120};
+
+  // the render fails once a chunk failed this often, either reported by its
+  // worker or because the worker died; slow chunks do not count
+  uint32_t maxFailures = 3;
+};
+
+// Renders frames [firstFrame, firstFrame + frameCount) into a file.
+using ChunkRenderer = std::function<bool(
+  uint64_t firstFrame,
+  uint64_t frameCount,
+  const std::filesystem::path& output
+)>;
+
+// Splits the frame range of an export into chunks and distributes them to
+// worker processes over a unix socket. Chunks of workers which die or fail
+// are redistributed, the finished chunks are stitched together in order.
+//
+// Protocol (one message per line):
+//   worker      -> coordinator: READY | DONE <chunk> | FAILED <chunk>
+//   coordinator -> worker:      CHUNK <chunk> <first> <count> <path> | EXIT
+class FarmCoordinator
+{
+ public:
+  FarmCoordinator(const FarmOptions& options);
+  ~FarmCoordinator();
+
+  FarmCoordinator(const FarmCoordinator&) = delete;
+  FarmCoordinator& operator=(const FarmCoordinator&) = delete;
+
+  int run();
+
+ private:
+  enum class ChunkState
+  {
+    Pending,
+    Rendering,
+    Done,
+  };
+
+  struct Chunk
+  {
+    uint64_t firstFrame = 0;
+    uint64_t frameCount = 0;
+    ChunkState state = ChunkState::Pending;
+    uint32_t renderers = 0;
+
+    // renders started, including duplicates, numbers the part files
+    uint32_t attempts = 0;
+    uint32_t failures = 0;
+    bool expired = false;
+    std::filesystem::path output;
+  };
+
+  struct Connection
+  {
+    int socket = -1;
+    std::string buffer;
+
+    bool ready = false;
+    bool assigned = false;
+    size_t chunk = 0;
+    std::filesystem::path output;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  bool listen();
+  bool spawnWorkers();
+  void reapWorkers();
+
+  void accept();
+  bool receive(Connection& connection);
+  bool handle(Connection& connection, std::string_view message);
+
+  void assign(Connection& connection);
+  void release(Connection& connection);
+  void expireChunks();
+
+  bool finished() const;
+  bool stitch();
+
+ private:
+  FarmOptions _options;
+
+  int _socket = -1;
+  std::vector<Chunk> _chunks;
+  std::vector<Connection> _connections;
+  std::vector<int> _workers;
+
+  bool _failed = false;
+};
+
+int runFarmWorker(
+  const std::filesystem::path& socketPath,
+  const ChunkRenderer& render
+);
+}  // namespace video